@@ -3,7 +3,8 @@
 EXECUTABLE=$1
 TEST=$2
 OPTS=$3
-TESTNAME=$(basename ${TEST} .lp)
+TESTNAME=$(basename ${TEST})
+TESTNAME=${TESTNAME%.*}
 TESTDIR=$(dirname ${TEST})
 OUTFILE=$(mktemp ${TESTNAME}.XXX)
 ${EXECUTABLE} -p ${TEST} -o ${OUTFILE} ${OPTS}
@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+
+# Time the kppm and defining-point engines on the given problems, and check
+# that they find the same front. The engines compared can be changed with
+# ENGINES, e.g. ENGINES="kppm balanced-box" for problems with two objectives.
+# Usage: compareEngines.sh EXECUTABLE "OPTIONS" PROBLEM...
+
+EXECUTABLE=$1
+OPTS=$2
+shift 2
+for TEST in "$@"; do
+  REFERENCE=""
+  FRONTS=""
+  for ENGINE in ${ENGINES:-kppm defining-point}; do
+    OUTFILE=$(mktemp)
+    ${EXECUTABLE} -p ${TEST} -o ${OUTFILE} --engine ${ENGINE} ${OPTS}
+    SECONDS_USED=$(grep 'elapsed seconds' ${OUTFILE} | awk '{print $1}')
+    IPS=$(grep 'IPs solved' ${OUTFILE} | awk '{print $1}')
+    printf "%s\t%s\t%s seconds\t%s IPs\n" $(basename ${TEST}) ${ENGINE} \
+      "${SECONDS_USED}" "${IPS}"
+    grep -v 'seconds\|solved\|Using' ${OUTFILE} > ${OUTFILE}.front
+    FRONTS="${FRONTS} ${OUTFILE}.front"
+    if [ -z "${REFERENCE}" ]; then
+      REFERENCE=${OUTFILE}.front
+    elif ! diff -q -w ${REFERENCE} ${OUTFILE}.front > /dev/null; then
+      echo "$(basename ${TEST}): ${ENGINE} found a different front"
+    fi
+    rm ${OUTFILE}
+  done
+  rm -f ${FRONTS}
+done
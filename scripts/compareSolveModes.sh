@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+
+# Time each --solve-mode on the given problems, counting only the time spent
+# in walk IPs, and check that they agree.
+# Usage: compareSolveModes.sh EXECUTABLE "OPTIONS" PROBLEM...
+
+EXECUTABLE=$1
+OPTS=$2
+shift 2
+for TEST in "$@"; do
+  REFERENCE=""
+  FRONTS=""
+  for MODE in sequential native; do
+    OUTFILE=$(mktemp)
+    ${EXECUTABLE} -p ${TEST} -o ${OUTFILE} --engine kppm --stats \
+      --solve-mode ${MODE} ${OPTS}
+    IP_SECONDS=$(grep 'seconds in walk IPs' ${OUTFILE} | awk '{print $1}')
+    IPS=$(grep 'IPs solved' ${OUTFILE} | awk '{print $1}')
+    printf "%s\t%s\t%s seconds in walk IPs\t%s IPs\n" $(basename ${TEST}) \
+      ${MODE} "${IP_SECONDS}" "${IPS}"
+    sed '/^---$/,$d' ${OUTFILE} | grep -v 'Using' > ${OUTFILE}.front
+    FRONTS="${FRONTS} ${OUTFILE}.front"
+    if [ -z "${REFERENCE}" ]; then
+      REFERENCE=${OUTFILE}.front
+    elif ! diff -q -w ${REFERENCE} ${OUTFILE}.front > /dev/null; then
+      echo "$(basename ${TEST}): ${MODE} found a different front"
+    fi
+    rm ${OUTFILE}
+  done
+  rm -f ${FRONTS}
+done
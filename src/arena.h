@@ -0,0 +1,139 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Bump allocation of small arrays out of large chunks. Nothing is freed on
+ * its own: all memory goes when the arena does. An arena is not
+ * thread-safe, so each task or store has its own.
+ */
+class Arena {
+  public:
+    Arena();
+    Arena(Arena && other);
+    ~Arena();
+
+    template <typename T> T * alloc(size_t n);
+    void * allocBytes(size_t bytes);
+
+  private:
+    Arena(const Arena &) = delete;
+    Arena & operator=(const Arena &) = delete;
+
+    // Chunks start small, as many tasks only find a handful of solutions,
+    // and double in size up to MAX_CHUNK.
+    static const size_t MIN_CHUNK = 1 << 10;
+    static const size_t MAX_CHUNK = 1 << 16;
+
+    std::vector<char *> chunks_;
+    char * next_;
+    char * end_;
+    size_t chunkBytes_;
+};
+
+/**
+ * Fixed-size slots, carved from an arena. Slots that are put back are
+ * reused before any new ones are carved. Like an arena, a pool is not
+ * thread-safe.
+ */
+class Pool {
+  public:
+    Pool(size_t slotBytes);
+
+    void * get();
+    void put(void * slot);
+
+    /**
+     * Hand over the arena holding every slot, leaving the pool empty.
+     */
+    Arena release();
+
+  private:
+    Arena arena_;
+    size_t slotBytes_;
+    void * free_;
+};
+
+inline Arena::Arena() : next_(nullptr), end_(nullptr),
+    chunkBytes_(MIN_CHUNK) {
+}
+
+inline Arena::Arena(Arena && other) : chunks_(std::move(other.chunks_)),
+    next_(other.next_), end_(other.end_), chunkBytes_(other.chunkBytes_) {
+  other.chunks_.clear();
+  other.next_ = other.end_ = nullptr;
+  other.chunkBytes_ = MIN_CHUNK;
+}
+
+inline Arena::~Arena() {
+  for(char * c: chunks_) {
+    delete[] c;
+  }
+}
+
+/* Every allocation is aligned for any type. */
+inline void * Arena::allocBytes(size_t bytes) {
+  const size_t align = alignof(std::max_align_t);
+  bytes = (bytes + align - 1) / align * align;
+  if (static_cast<size_t>(end_ - next_) < bytes) {
+    size_t size = chunkBytes_;
+    while (size < bytes) {
+      size *= 2;
+    }
+    if (chunkBytes_ < MAX_CHUNK)
+      chunkBytes_ *= 2;
+    // new[] gives memory aligned for any fundamental type.
+    next_ = new char[size];
+    end_ = next_ + size;
+    chunks_.push_back(next_);
+  }
+  void * res = next_;
+  next_ += bytes;
+  return res;
+}
+
+template <typename T>
+inline T * Arena::alloc(size_t n) {
+  return static_cast<T *>(allocBytes(n * sizeof(T)));
+}
+
+inline Pool::Pool(size_t slotBytes) :
+    slotBytes_(slotBytes < sizeof(void *) ? sizeof(void *) : slotBytes),
+    free_(nullptr) {
+}
+
+inline void * Pool::get() {
+  if (free_ == nullptr)
+    return arena_.allocBytes(slotBytes_);
+  void * slot = free_;
+  free_ = *static_cast<void **>(slot);
+  return slot;
+}
+
+inline void Pool::put(void * slot) {
+  *static_cast<void **>(slot) = free_;
+  free_ = slot;
+}
+
+inline Arena Pool::release() {
+  free_ = nullptr;
+  return std::move(arena_);
+}
+
+#endif /* ARENA_H */
@@ -0,0 +1,207 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <sstream>
+
+#include <ilcplex/cplexx.h>
+
+#include "balancedboxtask.h"
+#include "env.h"
+#include "lexopt.h"
+#include "problem.h"
+#include "trace.h"
+
+extern std::atomic<bool> interrupted;
+extern std::atomic<long> stoppedEarly;
+
+#ifdef DEBUG
+extern std::mutex debug_mutex;
+#endif
+
+BalancedBoxTask::Worker::Worker(const std::string & filename,
+    const Options * opts) : filename(filename) {
+  int status;
+  /* Initialize the CPLEX environment */
+  e.env = CPXopenCPLEX (&status);
+  if (status != 0) {
+    std::cerr << "Could not open CPLEX environment." << std::endl;
+  }
+
+  /* Set to deterministic parallel mode */
+  status = CPXsetintparam(e.env, CPXPARAM_Parallel, CPX_PARALLEL_DETERMINISTIC);
+
+  /* Set to only one thread */
+  CPXsetintparam(e.env, CPXPARAM_Threads, 1);
+
+  if (e.env == NULL) {
+    std::cerr << "Could not open CPLEX environment." << std::endl;
+  }
+
+  status = CPXsetintparam(e.env, CPX_PARAM_SCRIND, CPX_OFF);
+  if (status) {
+    std::cerr << "Failure to turn off screen indicator." << std::endl;
+  }
+
+  p = new Problem(this->filename.c_str(), e);
+  if (! opts->ideal.empty())
+    p->restrict(e, opts->ideal.data(), opts->worst.data());
+}
+
+BalancedBoxTask::Worker::~Worker() {
+  delete p;
+  CPXfreeprob(e.env, &e.lp);
+  CPXcloseCPLEX(&e.env);
+}
+
+/* The problem of the thread we run on. Every rectangle only changes the
+ * right-hand sides (and each solve sets all of them), so the problem is
+ * read once per thread rather than once per rectangle. */
+BalancedBoxTask::Worker & BalancedBoxTask::worker() {
+  static thread_local std::unique_ptr<Worker> w;
+  if ((! w) || (w->filename != filename_))
+    w.reset(new Worker(filename_, opts_));
+  return *w;
+}
+
+/* Find the lexicographic optimum under rhs, optimising objective first and
+ * then the other one. */
+int BalancedBoxTask::solve(Env & e, Problem & p, int first, double * rhs,
+    int * result) {
+  int order[2] = { first, 1 - first };
+  return lexicographicOptimum(e, p, order, 2, rhs, result, srhs_, soln_);
+}
+
+void BalancedBoxTask::keep(const int * result) {
+  int * n = newSolution();
+  for (int i = 0; i < objCountTotal_; ++i) {
+    n[i] = result[i];
+  }
+}
+
+/* Hand the rectangle between a and b to a new task, which finishes before
+ * any of ours do. */
+void BalancedBoxTask::split(const int * a, const int * b) {
+  if (! hasInterior(a, b))
+    return;
+  BalancedBoxTask * t = new BalancedBoxTask(filename_, sense_, opts_,
+      taskServer_, a, b);
+  for (auto n: nextLevel_) {
+    n->addPreReq(t);
+    t->addNextLevel(n);
+  }
+  taskServer_->q(t);
+}
+
+Status BalancedBoxTask::operator()() {
+  status_ = RUNNING;
+  if (interrupted) {
+    stoppedEarly++;
+    done();
+    return status_;
+  }
+#ifdef DEBUG
+  debug_mutex.lock();
+  std::cout << details();
+  debug_mutex.unlock();
+#endif
+  Worker & w = worker();
+  Env & e = w.e;
+  Problem & p = *w.p;
+  std::vector<double> rhs(p.rhs, p.rhs + p.objcnt);
+  std::vector<int> a(p.objcnt), b(p.objcnt);
+  std::vector<int> zbar(p.objcnt), zhat(p.objcnt);
+  bool found = true;
+
+  if (root_) {
+    // The corners of the whole front.
+    int solnstat = solve(e, p, 0, rhs.data(), a.data());
+    found = (solnstat != CPXMIP_INFEASIBLE) && (solnstat != CPXMIP_INForUNBD);
+    if (found) {
+      solve(e, p, 1, rhs.data(), b.data());
+      keep(a.data());
+      if (b != a)
+        keep(b.data());
+      if (opts_->trace != nullptr) {
+        double lower[2], upper[2];
+        for (int i = 0; i < 2; ++i) {
+          lower[i] = std::min(a[i], b[i]);
+          upper[i] = std::max(a[i], b[i]);
+        }
+        opts_->trace->setBounds(objectives_, lower, upper);
+      }
+    }
+  } else {
+    a.assign(a_.begin(), a_.end());
+    b.assign(b_.begin(), b_.end());
+  }
+
+  if (found && hasInterior(a.data(), b.data())) {
+    // The best point on objective 0 in the lower half. If there is none, b
+    // is the only point there.
+    double mid = (a[1] + b[1]) / 2.0;
+    rhs[0] = better(0, b[0]);
+    rhs[1] = (sense_ == MIN) ? std::floor(mid) : std::ceil(mid);
+    int solnstat = solve(e, p, 0, rhs.data(), zbar.data());
+    if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD)) {
+      zbar = b;
+    } else {
+      keep(zbar.data());
+    }
+    // The best point on objective 1 of what is left between a and zbar,
+    // which all lies in the upper half. If there is none, a is the only
+    // point there.
+    rhs[0] = better(0, zbar[0]);
+    rhs[1] = better(1, a[1]);
+    solnstat = solve(e, p, 1, rhs.data(), zhat.data());
+    if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD)) {
+      zhat = a;
+    } else {
+      keep(zhat.data());
+    }
+#ifdef DEBUG
+    debug_mutex.lock();
+    std::cout << str() << " found [" << zbar[0] << ", " << zbar[1];
+    std::cout << "] and [" << zhat[0] << ", " << zhat[1] << "]" << std::endl;
+    debug_mutex.unlock();
+#endif
+    // Nothing lies between zhat and zbar.
+    split(a.data(), zhat.data());
+    split(zbar.data(), b.data());
+  }
+
+  done();
+  return status_;
+}
+
+std::string BalancedBoxTask::str() const {
+  std::stringstream ss;
+  ss << "BalancedBoxTask: ";
+  if (root_) {
+    ss << "whole front";
+  } else {
+    ss << "[" << a_[0] << ", " << a_[1] << "] to [";
+    ss << b_[0] << ", " << b_[1] << "]";
+  }
+  return ss.str();
+}
+
+std::string BalancedBoxTask::details() const {
+  std::stringstream ss;
+  ss << str() << " is " << status_ << std::endl;
+  return ss.str();
+}
@@ -0,0 +1,127 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef BALANCEDBOXTASK_H
+#define BALANCEDBOXTASK_H
+
+#ifdef DEBUG
+#include <mutex>
+#endif
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "task.h"
+#include "env.h"
+#include "jobserver.h"
+#include "options.h"
+#include "problem.h"
+
+// The objectives of every BalancedBoxTask.
+static int bothObjectives[2] = { 0, 1 };
+
+/**
+ * Finds the nondominated points of a problem with two objectives by the
+ * balanced box method, instead of the general k-PPM levels.
+ *
+ * Each task holds a rectangle between two nondominated points a and b,
+ * where a is the better on objective 0 and b the better on objective 1. It
+ * halves the rectangle on objective 1, finds the point of the lower half
+ * that is best on objective 0 and then the point of the rest that is best on
+ * objective 1. Everything still unknown lies in the two rectangles between
+ * these new points and a and b, and each of these becomes a new task.
+ *
+ * The first task has no rectangle, and finds the two corners of the whole
+ * front instead.
+ */
+class BalancedBoxTask : public Task {
+  public:
+    BalancedBoxTask(std::string & filename, Sense sense, const Options * opts,
+        JobServer * taskServer);
+    BalancedBoxTask(std::string & filename, Sense sense, const Options * opts,
+        JobServer * taskServer, const int * a, const int * b);
+    Status operator()();
+
+    void addNextLevel(Task * nextLevel);
+
+    virtual std::string str() const;
+    virtual std::string details() const;
+    virtual bool certified() const;
+  private:
+    /** A CPLEX environment and the problem read into it, kept per thread. */
+    class Worker {
+      public:
+        Worker(const std::string & filename, const Options * opts);
+        ~Worker();
+        Env e;
+        Problem * p;
+        std::string filename;
+    };
+    Worker & worker();
+    int solve(Env & e, Problem & p, int first, double * rhs, int * result);
+    bool hasInterior(const int * a, const int * b) const;
+    int better(int o, int v) const;
+    void split(const int * a, const int * b);
+    void keep(const int * result);
+
+    JobServer * taskServer_;
+    std::list<Task *> nextLevel_;
+    const Options * opts_;
+    // Our corners, unless we are the first task.
+    bool root_;
+    std::vector<int> a_;
+    std::vector<int> b_;
+    // Scratch space for solve().
+    std::vector<double> srhs_;
+    std::vector<double> soln_;
+};
+
+inline BalancedBoxTask::BalancedBoxTask(std::string & filename, Sense sense,
+    const Options * opts, JobServer * taskServer) :
+    Task(filename, 2, 2, bothObjectives, sense),
+    taskServer_(taskServer), opts_(opts), root_(true) {
+}
+
+inline BalancedBoxTask::BalancedBoxTask(std::string & filename, Sense sense,
+    const Options * opts, JobServer * taskServer, const int * a,
+    const int * b) :
+    Task(filename, 2, 2, bothObjectives, sense),
+    taskServer_(taskServer), opts_(opts), root_(false), a_(a, a + 2),
+    b_(b, b + 2) {
+}
+
+inline void BalancedBoxTask::addNextLevel(Task * nextLevel) {
+  nextLevel_.push_back(nextLevel);
+}
+
+/* The value one step better than v on objective o. */
+inline int BalancedBoxTask::better(int o, int v) const {
+  int g = opts_->lattice.empty() ? 1 : opts_->lattice[o];
+  return (sense_ == MIN) ? v - g : v + g;
+}
+
+/* Could a nondominated point lie strictly between a and b? */
+inline bool BalancedBoxTask::hasInterior(const int * a, const int * b) const {
+  if (sense_ == MIN)
+    return (better(0, b[0]) > a[0]) && (better(1, a[1]) > b[1]);
+  return (better(0, b[0]) < a[0]) && (better(1, a[1]) < b[1]);
+}
+
+/* Every point we find is lexicographically optimal under bounds on both
+ * objectives, so nothing can dominate it. */
+inline bool BalancedBoxTask::certified() const {
+  return true;
+}
+
+#endif /* BALANCEDBOXTASK_H */
@@ -0,0 +1,158 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <vector>
+
+#include <ilcplex/cplexx.h>
+
+#include "boundtask.h"
+#include "env.h"
+#include "problem.h"
+
+extern std::atomic<int> ipcount;
+extern std::atomic<bool> interrupted;
+
+#ifdef DEBUG
+extern std::mutex debug_mutex;
+#endif
+
+/* Optimise coef, and return the bound CPLEX proves on its optimum. */
+static bool provenBound(Env & e, int cur_numcols, const int * ind,
+    const double * coef, double & value) {
+  int status = CPXXchgobj(e.env, e.lp, cur_numcols, ind, coef);
+  if (status) {
+    std::cerr << "Failed to set objective." << std::endl;
+    return false;
+  }
+  status = CPXXmipopt(e.env, e.lp);
+  ipcount++;
+  if (status) {
+    std::cerr << "Failed to optimize LP." << std::endl;
+    return false;
+  }
+  int solnstat = CPXXgetstat(e.env, e.lp);
+  if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD) ||
+      (solnstat == CPXMIP_UNBOUNDED))
+    return false;
+  status = CPXXgetbestobjval(e.env, e.lp, &value);
+  return (status == 0) && (std::abs(value) < CPX_INFBOUND);
+}
+
+Status BoundTask::operator()() {
+  status_ = RUNNING;
+  // Our values are only hints, so if stopped we just leave them infinite.
+  if (interrupted) {
+    done();
+    return status_;
+  }
+#ifdef DEBUG
+  debug_mutex.lock();
+  std::cout << details();
+  debug_mutex.unlock();
+#endif
+  Env e;
+
+  int status;
+  /* Initialize the CPLEX environment */
+  e.env = CPXopenCPLEX (&status);
+  if (status != 0) {
+    std::cerr << "Could not open CPLEX environment." << std::endl;
+  }
+
+  /* Set to deterministic parallel mode */
+  status = CPXsetintparam(e.env, CPXPARAM_Parallel, CPX_PARALLEL_DETERMINISTIC);
+
+  /* Set to only one thread */
+  CPXsetintparam(e.env, CPXPARAM_Threads, 1);
+
+  if (e.env == NULL) {
+    std::cerr << "Could not open CPLEX environment." << std::endl;
+  }
+
+  status = CPXsetintparam(e.env, CPX_PARAM_SCRIND, CPX_OFF);
+  if (status) {
+    std::cerr << "Failure to turn off screen indicator." << std::endl;
+  }
+
+  Problem p(filename_.c_str(), e);
+  int cur_numcols = CPXXgetnumcols(e.env, e.lp);
+  int o = objectives_[0];
+  // CPLEX only proves each bound up to its tolerances: every variable may be
+  // off by up to tol, and the value itself by a relative tol. So each bound
+  // is first moved out by that much, and only then (for an integral
+  // objective, whose values are multiples of g) moved in to the nearest
+  // multiple of g. No feasible value is cut off.
+  double integrality = 1e-5, feasibility = 1e-6;
+  CPXXgetdblparam(e.env, CPXPARAM_MIP_Tolerances_Integrality, &integrality);
+  CPXXgetdblparam(e.env, CPXPARAM_Simplex_Tolerances_Feasibility,
+      &feasibility);
+  double tol = std::max(integrality, feasibility);
+  double coefsum = 0;
+  for (int i = 0; i < cur_numcols; ++i) {
+    coefsum += std::abs(p.objcoef[o][i]);
+  }
+  auto slack = [tol, coefsum](double v) {
+    return tol * (std::abs(v) + coefsum + 1);
+  };
+  double g = p.objintegral[o] ? p.objgcd[o] : 0;
+  auto up = [g, slack](double v) {
+    v -= slack(v);
+    return (g > 0) ? std::ceil(v / g) * g : v;
+  };
+  auto down = [g, slack](double v) {
+    v += slack(v);
+    return (g > 0) ? std::floor(v / g) * g : v;
+  };
+
+  // The best value in our own sense, then the worst, as the best value of
+  // the negated objective.
+  double value;
+  if (provenBound(e, cur_numcols, p.objind[o], p.objcoef[o], value)) {
+    ideal_ = (sense_ == MIN) ? up(value) : down(value);
+  }
+  std::vector<double> negated(p.objcoef[o], p.objcoef[o] + cur_numcols);
+  for (auto & c: negated) {
+    c = -c;
+  }
+  if (provenBound(e, cur_numcols, p.objind[o], negated.data(), value)) {
+    worst_ = (sense_ == MIN) ? down(-value) : up(-value);
+  }
+#ifdef DEBUG
+  debug_mutex.lock();
+  std::cout << str() << ": ideal " << ideal_ << ", worst " << worst_;
+  std::cout << std::endl;
+  debug_mutex.unlock();
+#endif
+
+  CPXfreeprob(e.env, &e.lp);
+  CPXcloseCPLEX(&e.env);
+  done();
+  return status_;
+}
+
+std::string BoundTask::str() const {
+  std::stringstream ss;
+  ss << "BoundTask: objective " << objectives_[0];
+  return ss.str();
+}
+
+std::string BoundTask::details() const {
+  std::stringstream ss;
+  ss << str() << " is " << status_ << std::endl;
+  return ss.str();
+}
@@ -0,0 +1,65 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef BOUNDTASK_H
+#define BOUNDTASK_H
+
+#ifdef DEBUG
+#include <mutex>
+#endif
+
+#include <string>
+
+#include "task.h"
+#include "types.h"
+
+/**
+ * Finds the best and worst value that one objective takes over the feasible
+ * set, ignoring the other objectives. Over every objective, the best values
+ * form the ideal point, and the worst values bound the nadir point.
+ *
+ * Both values come from the bound that CPLEX proves, not from its incumbent,
+ * so they are safe even when the IPs stop at a gap. Either value stays
+ * infinite if its IP fails.
+ */
+class BoundTask : public Task {
+  public:
+    BoundTask(std::string & filename, int objCountTotal, Sense sense,
+        int objective);
+    Status operator()();
+
+    double ideal() const;
+    double worst() const;
+
+    virtual std::string str() const;
+    virtual std::string details() const;
+  private:
+    double ideal_;
+    double worst_;
+};
+
+inline BoundTask::BoundTask(std::string & filename, int objCountTotal,
+    Sense sense, int objective) :
+    Task(filename, 1, objCountTotal, &objective, sense),
+    ideal_((sense == MIN) ? -INF : INF), worst_((sense == MIN) ? INF : -INF) {
+}
+
+inline double BoundTask::ideal() const {
+  return ideal_;
+}
+
+inline double BoundTask::worst() const {
+  return worst_;
+}
+
+#endif /* BOUNDTASK_H */
@@ -16,30 +16,52 @@ You should have received a copy of the GNU General Public License along with thi
 #include "boxstore.h"
 
 
-void Box::split(int * s, BoxStore & store) {
-  double * lower = new double[this->dim_];
-  double * upper = new double[this->dim_];
-  for( int newBoxId = 1; newBoxId < (1 << dim_)-1; ++newBoxId) {
+/* split() with the dimension fixed at K, or dim_ if K is 0. For a fixed
+ * dimension the bounds of each new box are built on the stack. */
+template <int K>
+void Box::splitFixed(const int * s, BoxStore & store) {
+  const int dim = kernelWidth<K>(dim_);
+  double fixedLower[K > 0 ? K : 1];
+  double fixedUpper[K > 0 ? K : 1];
+  double * lower = fixedLower;
+  double * upper = fixedUpper;
+  if (K == 0) {
+    lower = new double[dim];
+    upper = new double[dim];
+  }
+  for( int newBoxId = 1; newBoxId < (1 << dim)-1; ++newBoxId) {
     bool emptyBox = false;
-    for( int d = 0; d < dim_; ++d) {
+    for( int d = 0; d < dim; ++d) {
       int o = objectives_[d];
       if ( (newBoxId & (1 << d)) != 0) {
         lower[d] = lower_[d];
         upper[d] = s[o];
-        if (lower[d] == upper[d])
-          emptyBox = true;
       } else {
         lower[d] = s[o];
         upper[d] = upper_[d];
-        if (lower[d] == upper[d])
-          emptyBox = true;
       }
+      if (lower[d] == upper[d])
+        emptyBox = true;
     }
     if (! emptyBox) {
-      Box *b = new Box(upper, lower, objectives_, dim_);
+      Box *b = new Box(upper, lower, objectives_, dim);
       store.insert(b);
     }
   }
-  delete[] lower;
-  delete[] upper;
+  if (K == 0) {
+    delete[] lower;
+    delete[] upper;
+  }
+}
+
+void Box::split(const int * s, BoxStore & store) {
+  switch (dim_) {
+    case 1: splitFixed<1>(s, store); break;
+    case 2: splitFixed<2>(s, store); break;
+    case 3: splitFixed<3>(s, store); break;
+    case 4: splitFixed<4>(s, store); break;
+    case 5: splitFixed<5>(s, store); break;
+    case 6: splitFixed<6>(s, store); break;
+    default: splitFixed<0>(s, store); break;
+  }
 }
@@ -17,20 +17,31 @@ You should have received a copy of the GNU General Public License along with thi
 #include <string>
 #include <sstream>
 
+#include "kernels.h"
+
 class BoxStore;
 
 class Box {
   public:
     Box(double * upper, double * lower, int * objectives, int dim);
     ~Box();
-    bool contains(int * s);
+    bool contains(const int * s) const;
+    template <int K> bool contains(const int * s) const;
 
-    void split(int * s, BoxStore & b);
+    void split(const int * s, BoxStore & b);
     double lower(int i) const;
     double upper(int i) const;
 
+    /**
+     * The number of integer points in the box, as a double since it may be
+     * huge.
+     */
+    double volume() const;
+
     std::string str() const;
   private:
+    template <int K> void splitFixed(const int * s, BoxStore & b);
+
     double * upper_;
     double * lower_;
     int * objectives_;
@@ -54,8 +65,15 @@ inline Box::~Box() {
   delete[] objectives_;
 }
 
-inline bool Box::contains(int * s) {
-  for(int i = 0; i < dim_; ++i) {
+inline bool Box::contains(const int * s) const {
+  return contains<0>(s);
+}
+
+/* contains() with the dimension fixed at K, or dim_ if K is 0. */
+template <int K>
+inline bool Box::contains(const int * s) const {
+  const int dim = kernelWidth<K>(dim_);
+  for(int i = 0; i < dim; ++i) {
     int o = objectives_[i];
     if (s[o] < lower_[i])
       return false;
@@ -73,6 +91,14 @@ inline double Box::lower(int i) const {
   return lower_[i];
 }
 
+inline double Box::volume() const {
+  double v = 1;
+  for(int i = 0; i < dim_; ++i) {
+    v *= upper_[i] - lower_[i] + 1;
+  }
+  return v;
+}
+
 inline std::string Box::str() const {
   std::stringstream ss;
   ss << "Box: [" << lower_[0];
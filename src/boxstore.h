@@ -19,11 +19,23 @@ You should have received a copy of the GNU General Public License along with thi
 
 #include "box.h"
 
+/* The first box containing sol. */
+template <int K>
+struct BoxSearch {
+  static Box * run(const std::list<Box *> & boxes, const int * sol) {
+    for(auto b: boxes) {
+      if (b->contains<K>(sol))
+        return b;
+    }
+    return nullptr;
+  }
+};
+
 class BoxStore {
   public:
     BoxStore(int dim);
     ~BoxStore();
-    Box * find(int * sol) const;
+    Box * find(const int * sol) const;
     void insert(Box * b);
     void remove(Box * b);
     size_t size() const;
@@ -34,11 +46,12 @@ class BoxStore {
   private:
     int dim_;
     std::list<Box *> boxes_;
+    Box * (*search_)(const std::list<Box *> & boxes, const int * sol);
 
 };
 
 inline BoxStore::BoxStore(int dim) :
-    dim_(dim) {
+    dim_(dim), search_(selectKernel<BoxSearch>(dim)) {
 }
 
 inline BoxStore::~BoxStore() {
@@ -47,12 +60,8 @@ inline BoxStore::~BoxStore() {
   }
 }
 
-inline Box * BoxStore::find(int * sol) const {
-  for(auto b: boxes_) {
-    if (b->contains(sol))
-      return b;
-  }
-  return nullptr;
+inline Box * BoxStore::find(const int * sol) const {
+  return search_(boxes_, sol);
 }
 
 inline void BoxStore::insert(Box * b) {
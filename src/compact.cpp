@@ -0,0 +1,167 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+/*
+ * Compacts a relaxation file written by kppm --cache-file. A record is
+ * dropped if another record with the same key answers every query it could
+ * answer, that is if the other record is a relaxation of it and either both
+ * are infeasible or both have the same result.
+ *
+ * Usage: kppm-compact INPUT [OUTPUT]
+ * If OUTPUT is not given, INPUT is replaced.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "relaxfile.h"
+
+static const size_t HEADER_BYTES = RelaxationFile::HEADER_BYTES;
+
+/* Does record b answer every query that record a answers? */
+static bool covers(const char * b, const char * a, int objcnt) {
+  uint32_t flagsA, flagsB;
+  memcpy(&flagsA, a + 8, sizeof(flagsA));
+  memcpy(&flagsB, b + 8, sizeof(flagsB));
+  if (flagsA != flagsB)
+    return false;
+  bool max = (flagsA & RelaxationFile::MAXIMISE) != 0;
+  bool infeasible = (flagsA & RelaxationFile::INFEASIBLE) != 0;
+  for (int i = 0; i < objcnt; ++i) {
+    double ipA, ipB;
+    memcpy(&ipA, a + 16 + i * sizeof(double), sizeof(double));
+    memcpy(&ipB, b + 16 + i * sizeof(double), sizeof(double));
+    if ((!max && (ipB < ipA)) || (max && (ipB > ipA)))
+      return false;
+  }
+  if (infeasible)
+    return true;
+  size_t res = 16 + objcnt * sizeof(double);
+  return memcmp(a + res, b + res, objcnt * sizeof(int32_t)) == 0;
+}
+
+int main(int argc, char* argv[]) {
+  if ((argc < 2) || (argc > 3)) {
+    std::cerr << "Usage: " << argv[0] << " INPUT [OUTPUT]" << std::endl;
+    return 1;
+  }
+  std::string inName(argv[1]);
+  std::string outName = (argc == 3) ? std::string(argv[2]) : inName + ".tmp";
+
+  std::ifstream in(inName, std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(in)),
+      std::istreambuf_iterator<char>());
+  if (data.size() < HEADER_BYTES) {
+    std::cerr << "Error: " << inName << " is not a relaxation file." << std::endl;
+    return 1;
+  }
+  uint32_t version, count;
+  memcpy(&version, &data[8], sizeof(version));
+  memcpy(&count, &data[12], sizeof(count));
+  if ((memcmp(&data[0], RelaxationFile::MAGIC,
+          sizeof(RelaxationFile::MAGIC)) != 0) ||
+      (version != RelaxationFile::VERSION)) {
+    std::cerr << "Error: " << inName << " is not a relaxation file we know.";
+    std::cerr << std::endl;
+    return 1;
+  }
+  int objcnt = count;
+  size_t recLen = RelaxationFile::recordBytes(objcnt);
+  size_t numRecs = (data.size() - HEADER_BYTES) / recLen;
+
+  // Sort the records so that only records which could cover each other are
+  // next to each other: by key, then flags, then result. Within such a run,
+  // a record is only covered by one at least as relaxed in every objective,
+  // and so lexicographically at least as relaxed, so we sort the most relaxed
+  // first. Identical records keep their original order.
+  std::vector<size_t> order(numRecs);
+  for (size_t r = 0; r < numRecs; ++r)
+    order[r] = r;
+  const size_t res = 16 + objcnt * sizeof(double);
+  auto record = [&data, recLen](size_t r) {
+    return &data[HEADER_BYTES + r * recLen];
+  };
+  auto sameRun = [&](size_t a, size_t b) {
+    return memcmp(record(a), record(b), 16) == 0 &&
+      memcmp(record(a) + res, record(b) + res, objcnt * sizeof(int32_t)) == 0;
+  };
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      const char * ra = record(a);
+      const char * rb = record(b);
+      uint64_t keyA, keyB;
+      memcpy(&keyA, ra, sizeof(keyA));
+      memcpy(&keyB, rb, sizeof(keyB));
+      if (keyA != keyB)
+        return keyA < keyB;
+      uint32_t flags;
+      memcpy(&flags, ra + 8, sizeof(flags));
+      int c = memcmp(ra + 8, rb + 8, sizeof(flags));
+      if (c == 0)
+        c = memcmp(ra + res, rb + res, objcnt * sizeof(int32_t));
+      if (c != 0)
+        return c < 0;
+      bool max = (flags & RelaxationFile::MAXIMISE) != 0;
+      for (int i = 0; i < objcnt; ++i) {
+        double ipA, ipB;
+        memcpy(&ipA, ra + 16 + i * sizeof(double), sizeof(double));
+        memcpy(&ipB, rb + 16 + i * sizeof(double), sizeof(double));
+        if (ipA != ipB)
+          return max ? (ipA < ipB) : (ipA > ipB);
+      }
+      return false;
+    });
+
+  // A record can now only be covered by an earlier one in its run, and only
+  // records we keep need to be checked.
+  std::vector<bool> keep(numRecs, true);
+  std::vector<size_t> kept;
+  for (size_t i = 0; i < numRecs; ++i) {
+    if ((i == 0) || !sameRun(order[i - 1], order[i]))
+      kept.clear();
+    for (size_t k : kept) {
+      if (covers(record(k), record(order[i]), objcnt)) {
+        keep[order[i]] = false;
+        break;
+      }
+    }
+    if (keep[order[i]])
+      kept.push_back(order[i]);
+  }
+
+  std::ofstream out(outName, std::ios::binary | std::ios::trunc);
+  out.write(&data[0], HEADER_BYTES);
+  size_t written = 0;
+  for (size_t r = 0; r < numRecs; ++r) {
+    if (keep[r]) {
+      out.write(record(r), recLen);
+      written++;
+    }
+  }
+  out.close();
+  if (! out) {
+    std::cerr << "Error: Could not write " << outName << std::endl;
+    return 1;
+  }
+  if ((argc == 2) && (std::rename(outName.c_str(), inName.c_str()) != 0)) {
+    std::cerr << "Error: Could not replace " << inName << std::endl;
+    return 1;
+  }
+  std::cout << "Kept " << written << " of " << numRecs << " records." << std::endl;
+  return 0;
+}
@@ -0,0 +1,126 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <atomic>
+#include <string>
+#include <sstream>
+
+#include <ilcplex/cplexx.h>
+
+#include "definingpointtask.h"
+#include "env.h"
+#include "lexopt.h"
+#include "problem.h"
+
+extern std::atomic<bool> interrupted;
+extern std::atomic<long> stoppedEarly;
+
+#ifdef DEBUG
+extern std::mutex debug_mutex;
+#endif
+
+Status DefiningPointTask::operator()() {
+  status_ = RUNNING;
+  if (interrupted) {
+    stoppedEarly++;
+    region_.reset();
+    done();
+    return status_;
+  }
+  Env e;
+
+  int status;
+  /* Initialize the CPLEX environment */
+  e.env = CPXopenCPLEX (&status);
+  if (status != 0) {
+    std::cerr << "Could not open CPLEX environment." << std::endl;
+  }
+
+  /* Set to deterministic parallel mode */
+  status = CPXsetintparam(e.env, CPXPARAM_Parallel, CPX_PARALLEL_DETERMINISTIC);
+
+  /* Set to only one thread */
+  CPXsetintparam(e.env, CPXPARAM_Threads, 1);
+
+  if (e.env == NULL) {
+    std::cerr << "Could not open CPLEX environment." << std::endl;
+  }
+
+  status = CPXsetintparam(e.env, CPX_PARAM_SCRIND, CPX_OFF);
+  if (status) {
+    std::cerr << "Failure to turn off screen indicator." << std::endl;
+  }
+
+  Problem p(filename_.c_str(), e);
+  std::vector<double> rhs(p.objcnt);
+  std::vector<int> result(p.objcnt);
+
+  while (region_->next(rhs.data())) {
+    int solnstat = lexicographicOptimum(e, p, objectives_, objCount_,
+        rhs.data(), result.data(), srhs_, soln_);
+    bool infeasible = (solnstat == CPXMIP_INFEASIBLE) ||
+      (solnstat == CPXMIP_INForUNBD);
+#ifdef DEBUG
+    debug_mutex.lock();
+    std::cout << str() << " with constraints ";
+    for(int i = 0; i < p.objcnt; ++i) {
+      if (rhs[i] > 1e09)
+        std::cout << "∞";
+      else if (rhs[i] < -1e09)
+        std::cout << "-∞";
+      else
+        std::cout << rhs[i];
+      std::cout << ",";
+    }
+    std::cout << " found ";
+    if (infeasible) {
+      std::cout << "infeasible";
+    } else {
+      for(int i = 0; i < p.objcnt; ++i) {
+        std::cout << result[i] << ",";
+      }
+    }
+    std::cout << std::endl;
+    debug_mutex.unlock();
+#endif
+    if (infeasible) {
+      region_->empty(rhs.data());
+    } else if (region_->found(rhs.data(), result.data())) {
+      int * n = newSolution();
+      for (int i = 0; i < objCountTotal_; ++i) {
+        n[i] = result[i];
+      }
+    }
+  }
+  if (interrupted)
+    stoppedEarly++;
+  CPXfreeprob(e.env, &e.lp);
+  CPXcloseCPLEX(&e.env);
+  // Release our hold on the region, so that the last worker frees it.
+  region_.reset();
+
+  done();
+  return status_;
+}
+
+std::string DefiningPointTask::str() const {
+  std::stringstream ss;
+  ss << "DefiningPointTask: " << objCount_ << " objectives";
+  return ss.str();
+}
+
+std::string DefiningPointTask::details() const {
+  std::stringstream ss;
+  ss << str() << " is " << status_ << std::endl;
+  return ss.str();
+}
@@ -0,0 +1,66 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef DEFININGPOINTTASK_H
+#define DEFININGPOINTTASK_H
+
+#ifdef DEBUG
+#include <mutex>
+#endif
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "task.h"
+#include "searchregion.h"
+
+/**
+ * One worker of the defining point method, which searches every objective
+ * at once rather than building up through subsets of them.
+ *
+ * Each worker repeatedly takes a zone from the shared SearchRegion and finds
+ * the lexicographic optimum inside it, until no zones are left. Each zone
+ * either turns out to be empty, or yields a new nondominated point, which
+ * then splits every zone holding it. One worker runs per thread, so each
+ * opens CPLEX and reads the problem only once.
+ */
+class DefiningPointTask : public Task {
+  public:
+    DefiningPointTask(std::string & filename, int objCount, int * objectives,
+        Sense sense, std::shared_ptr<SearchRegion> region);
+    Status operator()();
+
+    virtual std::string str() const;
+    virtual std::string details() const;
+    virtual bool certified() const;
+  private:
+    std::shared_ptr<SearchRegion> region_;
+    // Scratch space for lexicographicOptimum().
+    std::vector<double> srhs_;
+    std::vector<double> soln_;
+};
+
+inline DefiningPointTask::DefiningPointTask(std::string & filename,
+    int objCount, int * objectives, Sense sense,
+    std::shared_ptr<SearchRegion> region) :
+    Task(filename, objCount, objCount, objectives, sense), region_(region) {
+}
+
+/* Every point is lexicographically optimal under upper bounds on every
+ * objective, so nothing can dominate it. */
+inline bool DefiningPointTask::certified() const {
+  return true;
+}
+
+#endif /* DEFININGPOINTTASK_H */
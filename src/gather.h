@@ -14,24 +14,85 @@ You should have received a copy of the GNU General Public License along with thi
 #ifndef GATHER_H
 #define GATHER_H
 
+#include <mutex>
 #include <sstream>
+#include <unordered_set>
 
+#include "resultwriter.h"
+#include "trace.h"
 #include "task.h"
 
+/**
+ * The final task, which collects the solutions of the whole problem.
+ *
+ * If given a writer, each certified solution is written as soon as it
+ * reaches the archive, as nothing found later can dominate it. If given a
+ * trace, every solution that reaches the archive is added to it.
+ */
 class Gather : public Task {
   public:
-    Gather(std::string problem, int objCount, int * objectives, Sense sense);
+    Gather(std::string problem, int objCount, int * objectives, Sense sense,
+        ResultWriter * writer = nullptr, Trace * trace = nullptr);
 
     virtual Status operator()();
 
     virtual std::string str() const;
     virtual std::string details() const;
 
+    /**
+     * Write every solution that has not already been streamed.
+     */
+    void writeRemaining(ResultWriter & writer);
+
+  protected:
+    virtual void receive(std::shared_ptr<const SolutionBlock> b,
+        bool certified);
+
+  private:
+    ResultWriter * writer_;
+    Trace * trace_;
+    std::mutex streamMutex_;
+    std::unordered_set<const int *> streamed_;
 };
 
 inline Gather::Gather(std::string problem, int objCount,
-    int * objectives, Sense sense) :
-    Task(problem, objCount, objCount, objectives, sense) {
+    int * objectives, Sense sense, ResultWriter * writer, Trace * trace) :
+    Task(problem, objCount, objCount, objectives, sense), writer_(writer),
+    trace_(trace) {
+  archive_ = new ParetoArchive(objCount_, objCountTotal_, sense_);
+}
+
+inline void Gather::receive(std::shared_ptr<const SolutionBlock> b,
+    bool certified) {
+  bool stream = (writer_ != nullptr) && certified;
+  if (((! stream) && (trace_ == nullptr)) || (! b)) {
+    Task::receive(b, certified);
+    return;
+  }
+  {
+    // A certified solution can only be turned away as a duplicate, in which
+    // case its twin is written by writeRemaining().
+    std::unique_lock<std::mutex> lock(streamMutex_);
+    for (const int * s: b->solutions()) {
+      const int * kept = archive_->insert(s);
+      if (kept == nullptr)
+        continue;
+      if (trace_ != nullptr)
+        trace_->insert(kept);
+      if (stream) {
+        writer_->write(kept);
+        streamed_.insert(kept);
+      }
+    }
+  }
+}
+
+inline void Gather::writeRemaining(ResultWriter & writer) {
+  std::unique_lock<std::mutex> lock(streamMutex_);
+  for (const int * s: solutions()) {
+    if (streamed_.count(s) == 0)
+      writer.write(s);
+  }
 }
 
 inline Status Gather::operator()() {
@@ -0,0 +1,168 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+
+#include "hypervolume.h"
+
+Staircase::Staircase(double rx, double ry) : rx_(rx), ry_(ry), area_(0) {
+}
+
+/* The area gained is the part of [x, rx) x [y, ry) above the staircase.
+ * Walking right from x, the staircase height only drops, so we stop at the
+ * first step at or below y. Steps passed on the way are dominated by (x, y),
+ * and are removed. */
+double Staircase::add(double x, double y) {
+  if ((x >= rx_) || (y >= ry_))
+    return 0;
+  double h = ry_;
+  auto it = steps_.upper_bound(x);
+  if (it != steps_.begin()) {
+    auto prev = std::prev(it);
+    if (prev->second <= y)
+      return 0;
+    h = prev->second;
+    if (prev->first == x)
+      steps_.erase(prev);
+  }
+  double u = x;
+  double gain = 0;
+  while ((it != steps_.end()) && (it->second >= y)) {
+    gain += (it->first - u) * (h - y);
+    u = it->first;
+    h = it->second;
+    it = steps_.erase(it);
+  }
+  gain += (((it != steps_.end()) ? it->first : rx_) - u) * (h - y);
+  steps_.emplace_hint(it, x, y);
+  area_ += gain;
+  return gain;
+}
+
+Hypervolume::Hypervolume(int k, Sense sense, const double * ideal,
+    const double * reference) : k_(k), sense_(sense), value_(0),
+    boxVolume_(1), ideal_(k), ref_(k), point_(k), stair_(0, 0),
+    stale_(false) {
+  for (int i = 0; i < k_; ++i) {
+    ideal_[i] = (sense_ == MIN) ? ideal[i] : -ideal[i];
+    ref_[i] = (sense_ == MIN) ? reference[i] : -reference[i];
+    boxVolume_ *= std::max(0.0, ref_[i] - ideal_[i]);
+  }
+  if (k_ == 2) {
+    stair_ = Staircase(ref_[0], ref_[1]);
+  } else if (k_ > 3) {
+    // Fixed seed, so that runs can be compared.
+    std::mt19937 gen(5489u);
+    samples_.resize(SAMPLES * k_);
+    for (int s = 0; s < SAMPLES; ++s) {
+      for (int i = 0; i < k_; ++i) {
+        std::uniform_real_distribution<double> d(ideal_[i], ref_[i]);
+        samples_[s * k_ + i] = d(gen);
+      }
+    }
+  }
+}
+
+double Hypervolume::add(const int * s) {
+  for (int i = 0; i < k_; ++i) {
+    point_[i] = (sense_ == MIN) ? s[i] : -s[i];
+    // Points outside the box add nothing, and neither can any point they
+    // dominate.
+    if (point_[i] >= ref_[i])
+      return 0;
+  }
+  double gain = 0;
+  if (k_ == 1) {
+    gain = std::max(0.0, ref_[0] - point_[0] - value_);
+  } else if (k_ == 2) {
+    gain = stair_.add(point_[0], point_[1]);
+  } else if (k_ == 3) {
+    points_.insert(points_.end(), point_.begin(), point_.end());
+    stale_ = true;
+  } else {
+    gain = addSampled();
+  }
+  value_ += gain;
+  return gain;
+}
+
+/* Sweep up the third objective over every point, adding each to a 2D
+ * staircase. Between one point and the next, the volume grows by the area of
+ * the staircase. A point that adds no area is dominated by one before it,
+ * and is dropped. */
+double Hypervolume::refresh() {
+  if (! stale_)
+    return 0;
+  size_t n = points_.size() / 3;
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i) {
+    order[i] = 3 * i;
+  }
+  // By the third objective, then the others, so that of two points with the
+  // same third value, one dominating the other comes first.
+  const double * v = points_.data();
+  std::sort(order.begin(), order.end(), [v](size_t a, size_t b) {
+        if (v[a + 2] != v[b + 2])
+          return v[a + 2] < v[b + 2];
+        if (v[a] != v[b])
+          return v[a] < v[b];
+        return v[a + 1] < v[b + 1];
+      });
+  Staircase slice(ref_[0], ref_[1]);
+  std::vector<double> kept;
+  kept.reserve(points_.size());
+  double volume = 0;
+  double z = (n > 0) ? v[order[0] + 2] : ref_[2];
+  for (size_t i: order) {
+    const double * q = v + i;
+    volume += slice.area() * (q[2] - z);
+    z = q[2];
+    if (slice.add(q[0], q[1]) > 0)
+      kept.insert(kept.end(), q, q + 3);
+  }
+  volume += slice.area() * (ref_[2] - z);
+  points_.swap(kept);
+  stale_ = false;
+  double gain = volume - value_;
+  value_ = volume;
+  return gain;
+}
+
+/* Each sample that the new point dominates is worth an equal share of the
+ * box. Dominated samples are moved to the end and forgotten. */
+double Hypervolume::addSampled() {
+  const double * p = point_.data();
+  size_t n = samples_.size();
+  size_t covered = 0;
+  for (size_t s = 0; s < n; ) {
+    const double * v = &samples_[s];
+    bool dominated = true;
+    for (int i = 0; i < k_; ++i) {
+      if (p[i] > v[i]) {
+        dominated = false;
+        break;
+      }
+    }
+    if (dominated) {
+      n -= k_;
+      std::copy(&samples_[n], &samples_[n] + k_, &samples_[s]);
+      covered++;
+    } else {
+      s += k_;
+    }
+  }
+  samples_.resize(n);
+  return boxVolume_ * covered / SAMPLES;
+}
@@ -0,0 +1,132 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef HYPERVOLUME_H
+#define HYPERVOLUME_H
+
+#include <map>
+#include <vector>
+
+#include "sense.h"
+
+/**
+ * The area dominated by a set of points in two dimensions, within a
+ * reference point, when minimising. Points are added one at a time, and the
+ * set is kept as a staircase, so each addition takes O(log n).
+ */
+class Staircase {
+  public:
+    Staircase(double rx, double ry);
+
+    /**
+     * Add the point (x, y), and return the area this adds.
+     */
+    double add(double x, double y);
+    double area() const;
+
+  private:
+    double rx_;
+    double ry_;
+    double area_;
+    // From x to y. The y values strictly decrease along the map.
+    std::map<double, double> steps_;
+};
+
+/**
+ * The hypervolume dominated by a growing set of points, within a box from
+ * the ideal corner to a reference point.
+ *
+ * Points are added one at a time. Dominated points (and points outside the
+ * box) add nothing, so nothing ever needs to be removed.
+ *
+ * For two objectives, each addition updates the value in O(log n). For more
+ * than three, the value is a Monte-Carlo estimate from a fixed set of samples
+ * in the box, which each addition checks once.
+ *
+ * For three objectives, an exact update per point costs O(n) or more, which
+ * is too slow for large fronts. Points are only stored, and the value is
+ * brought up to date by refresh(), which sweeps all of them once in
+ * O(n log n). Callers refresh at intervals, or before reading value().
+ */
+class Hypervolume {
+  public:
+    static const int SAMPLES = 8192;
+
+    /**
+     * ideal and reference hold one value per objective, in the order used by
+     * the points.
+     */
+    Hypervolume(int k, Sense sense, const double * ideal,
+        const double * reference);
+
+    /**
+     * Add a point, and return the volume this adds to value(). With three
+     * objectives, this is always 0 until refresh().
+     */
+    double add(const int * s);
+    double value() const;
+
+    /**
+     * Are points missing from value(), until refresh()?
+     */
+    bool stale() const;
+
+    /**
+     * Bring value() up to date with every point added, and return the
+     * volume this adds.
+     */
+    double refresh();
+
+    /**
+     * The volume of the whole box, which bounds value().
+     */
+    double boxVolume() const;
+
+  private:
+    double addSampled();
+
+    int k_;
+    Sense sense_;
+    double value_;
+    double boxVolume_;
+    // In minimisation terms.
+    std::vector<double> ideal_;
+    std::vector<double> ref_;
+    std::vector<double> point_;
+
+    Staircase stair_;
+    // Three objectives: the points so far, three values each. Those that
+    // were dominated at the last refresh() are gone.
+    std::vector<double> points_;
+    bool stale_;
+    // More objectives: samples not yet dominated, k_ values each.
+    std::vector<double> samples_;
+};
+
+inline double Staircase::area() const {
+  return area_;
+}
+
+inline double Hypervolume::value() const {
+  return value_;
+}
+
+inline bool Hypervolume::stale() const {
+  return stale_;
+}
+
+inline double Hypervolume::boxVolume() const {
+  return boxVolume_;
+}
+
+#endif /* HYPERVOLUME_H */
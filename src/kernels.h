@@ -0,0 +1,130 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "sense.h"
+
+/**
+ * The innermost loops of k-PPM compare short vectors of objective values,
+ * one entry per objective, with the sense of the problem deciding which way
+ * each comparison goes. The functions here are templated on the number of
+ * objectives K and the sense S, so that for small K the loops are fully
+ * unrolled and the sense is not tested inside them. K = 0 is the generic
+ * version, where the number of objectives is only known at run time.
+ *
+ * Callers wrap a whole loop in a class template with a static run()
+ * function, and use selectKernel() to pick the right instantiation once,
+ * rather than branching on the number of objectives for every comparison.
+ * Only up to 6 objectives get their own instantiation.
+ */
+
+template <int K>
+inline int kernelWidth(int count) {
+  return (K > 0) ? K : count;
+}
+
+/* Is the rhs a at least as loose as the rhs b? */
+template <Sense S>
+inline bool looser(double a, double b) {
+  return (S == MIN) ? (a >= b) : (a <= b);
+}
+
+/* Is lp a relaxation of ip, i.e. is every rhs of lp at least as loose? */
+template <int K, Sense S>
+inline bool relaxes(const double * lp, const double * ip, int count) {
+  const int n = kernelWidth<K>(count);
+  for (int i = 0; i < n; ++i) {
+    if (! looser<S>(lp[i], ip[i]))
+      return false;
+  }
+  return true;
+}
+
+/* Does result satisfy every rhs of ip? */
+template <int K, Sense S>
+inline bool satisfies(const int * result, const double * ip, int count) {
+  const int n = kernelWidth<K>(count);
+  for (int i = 0; i < n; ++i) {
+    if (! looser<S>(ip[i], result[i]))
+      return false;
+  }
+  return true;
+}
+
+/* Is a at least as good as b in every objective, and better in one? */
+template <int K, Sense S>
+inline bool dominates(const int * a, const int * b, int count) {
+  const int n = kernelWidth<K>(count);
+  bool better = false;
+  for (int i = 0; i < n; ++i) {
+    if ((S == MIN) ? (a[i] > b[i]) : (a[i] < b[i]))
+      return false;
+    if (a[i] != b[i])
+      better = true;
+  }
+  return better;
+}
+
+/* Is a at least as good as b in every objective? */
+template <int K, Sense S>
+inline bool weaklyDominates(const int * a, const int * b, int count) {
+  const int n = kernelWidth<K>(count);
+  for (int i = 0; i < n; ++i) {
+    if ((S == MIN) ? (a[i] > b[i]) : (a[i] < b[i]))
+      return false;
+  }
+  return true;
+}
+
+/* F<K>::run for the given number of objectives. */
+template <template <int> class F>
+inline decltype(&F<0>::run) selectKernel(int count) {
+  switch (count) {
+    case 1: return &F<1>::run;
+    case 2: return &F<2>::run;
+    case 3: return &F<3>::run;
+    case 4: return &F<4>::run;
+    case 5: return &F<5>::run;
+    case 6: return &F<6>::run;
+    default: return &F<0>::run;
+  }
+}
+
+/* F<K, S>::run for the given number of objectives and sense. */
+template <template <int, Sense> class F>
+inline decltype(&F<0, MIN>::run) selectKernel(int count, Sense sense) {
+  if (sense == MIN) {
+    switch (count) {
+      case 1: return &F<1, MIN>::run;
+      case 2: return &F<2, MIN>::run;
+      case 3: return &F<3, MIN>::run;
+      case 4: return &F<4, MIN>::run;
+      case 5: return &F<5, MIN>::run;
+      case 6: return &F<6, MIN>::run;
+      default: return &F<0, MIN>::run;
+    }
+  }
+  switch (count) {
+    case 1: return &F<1, MAX>::run;
+    case 2: return &F<2, MAX>::run;
+    case 3: return &F<3, MAX>::run;
+    case 4: return &F<4, MAX>::run;
+    case 5: return &F<5, MAX>::run;
+    case 6: return &F<6, MAX>::run;
+    default: return &F<0, MAX>::run;
+  }
+}
+
+#endif /* KERNELS_H */
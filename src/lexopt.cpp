@@ -0,0 +1,92 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <ilcplex/cplexx.h>
+
+#include "lexopt.h"
+
+extern std::atomic<int> ipcount;
+
+int lexicographicOptimum(Env & e, Problem & p, const int * order, int count,
+    const double * rhs, int * result, std::vector<double> & srhs,
+    std::vector<double> & soln) {
+  int cur_numcols, status, solnstat = CPXMIP_OPTIMAL;
+  double objval;
+  srhs.assign(rhs, rhs + p.objcnt);
+  cur_numcols = CPXXgetnumcols(e.env, e.lp);
+  std::vector<char> done(p.objcnt, false);
+
+  for (int i = 0; i < count; ++i) {
+    int j = order[i];
+    done[j] = true;
+    status = CPXXchgobj(e.env, e.lp, cur_numcols, p.objind[j], p.objcoef[j]);
+    if (status) {
+      std::cerr << "Failed to set objective." << std::endl;
+    }
+    status = CPXXchgrhs(e.env, e.lp, p.objcnt, p.conind, srhs.data());
+    if (status) {
+      std::cerr << "Failed to change constraint srhs" << std::endl;
+    }
+    status = CPXXmipopt(e.env, e.lp);
+    ipcount++;
+    if (status) {
+      std::cerr << "Failed to optimize LP." << std::endl;
+    }
+    solnstat = CPXgetstat(e.env, e.lp);
+    if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD)) {
+      return solnstat;
+    }
+    status = CPXXgetobjval(e.env, e.lp, &objval);
+    if ( status ) {
+      std::cerr << "Failed to obtain objective value." << std::endl;
+      exit(0);
+    }
+    if ( objval > 1/p.mip_tolerance ) {
+      while (objval > 1/p.mip_tolerance) {
+        p.mip_tolerance /= 10;
+      }
+      CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_MIPGap, p.mip_tolerance);
+      status = CPXXmipopt(e.env, e.lp);
+      ipcount++;
+      solnstat = CPXgetstat(e.env, e.lp);
+      if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD)) {
+        return solnstat;
+      }
+      status = CPXXgetobjval(e.env, e.lp, &objval);
+      if ( status ) {
+        std::cerr << "Failed to obtain objective value." << std::endl;
+        exit(0);
+      }
+    }
+    result[j] = srhs[j] = round(objval);
+  }
+
+  // Get the solution vector, and from it the rest of the objectives.
+  soln.resize(cur_numcols);
+  CPXXgetx(e.env, e.lp, soln.data(), 0, cur_numcols - 1);
+  for (int j = 0; j < p.objcnt; j++) {
+    if (done[j])
+      continue;
+    double res = 0;
+    for(int i = 0; i < cur_numcols; ++i) {
+      res += p.objcoef[j][i] * soln[i];
+    }
+    result[j] = round(res);
+  }
+  return solnstat;
+}
@@ -0,0 +1,33 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef LEXOPT_H
+#define LEXOPT_H
+
+#include <vector>
+
+#include "env.h"
+#include "problem.h"
+
+/**
+ * Find the lexicographic optimum over count objectives, in the given order,
+ * subject to rhs on every objective. Each objective is optimised in turn and
+ * then fixed at its optimum. Every objective of the optimum is filled in in
+ * result, and the solution vector is left in soln. srhs is scratch space.
+ * Returns the CPLEX MIP status of the last solve.
+ */
+int lexicographicOptimum(Env & e, Problem & p, const int * order, int count,
+    const double * rhs, int * result, std::vector<double> & srhs,
+    std::vector<double> & soln);
+
+#endif /* LEXOPT_H */
@@ -0,0 +1,61 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef LEXWEIGHTS_H
+#define LEXWEIGHTS_H
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Largest magnitude of a weighted sum of objectives that we hand to the
+ * solver as one objective. The weighted IPs are solved with a gap of under
+ * one unit and no integrality tolerance, so the solver's relative errors
+ * (around 1e-9) must stay far below one unit of the sum.
+ */
+static const double MAX_WEIGHTED = 1e7;
+
+/**
+ * The largest magnitude that the weighted sum of count objectives can take,
+ * if objective i lies between lower[i] and upper[i].
+ */
+inline double weightedSumBound(const double * weights, const double * lower,
+    const double * upper, int count) {
+  double largest = 0;
+  for (int i = 0; i < count; ++i) {
+    largest += std::abs(weights[i]) *
+      std::max(std::abs(lower[i]), std::abs(upper[i]));
+  }
+  return largest;
+}
+
+/**
+ * Find integer weights for count integral objectives, in priority order,
+ * such that optimising the weighted sum gives the lexicographic optimum.
+ * Every value of objective i is a multiple of step[i] between lower[i] and
+ * upper[i]. Returns false if the weighted sum could exceed MAX_WEIGHTED.
+ *
+ * The weights form a mixed radix: moving objective i by its smallest step
+ * must outweigh moving every later objective across its whole range.
+ */
+inline bool lexicographicWeights(const int * step, const double * lower,
+    const double * upper, int count, double * weights) {
+  double later = 0; // Largest change in the weighted sum of later objectives
+  for (int i = count - 1; i >= 0; --i) {
+    weights[i] = std::floor(later / step[i]) + 1;
+    later += weights[i] * (upper[i] - lower[i]);
+  }
+  return weightedSumBound(weights, lower, upper, count) <= MAX_WEIGHTED;
+}
+
+#endif /* LEXWEIGHTS_H */
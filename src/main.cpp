@@ -12,22 +12,37 @@ You should have received a copy of the GNU General Public License along with thi
 */
 
 
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
-#include <iomanip>
 #include <fstream>
+#include <new>
 #include <queue>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include <ilcplex/cplex.h>
 
 #include <boost/program_options.hpp>
 
+#include "balancedboxtask.h"
+#include "boundtask.h"
+#include "definingpointtask.h"
 #include "gather.h"
 #include "jobserver.h"
 #include "p1task.h"
 #include "p2task.h"
 #include "problem.h"
 #include "env.h"
+#include "options.h"
+#include "relaxfile.h"
+#include "resultwriter.h"
+#include "searchregion.h"
+#include "supportedtask.h"
+#include "trace.h"
 
 
 
@@ -39,17 +54,106 @@ std::mutex debug_mutex;
 
 
 std::atomic<int> ipcount;
+// Time spent in the IPs of P3Tasks, summed over threads.
+std::atomic<long> ipnanos;
+std::atomic<long> poolharvested;
+std::atomic<long> mipstarts;
+// IPs solved by P3Tasks, and the branch-and-bound nodes they took.
+std::atomic<long> walkips;
+std::atomic<long> ipnodes;
+std::atomic<long> cutoffs;
+// LP relaxations solved to screen out infeasible IPs, and the IPs skipped.
+std::atomic<long> lpscreens;
+std::atomic<long> lpscreened;
+// IPs skipped as they ask for better than the ideal point.
+std::atomic<long> idealskipped;
+// Weighted sums of --supported too large to solve exactly, and skipped.
+std::atomic<long> weightedskipped;
+std::atomic<long> cachehits;
+std::atomic<long> cachemisses;
+std::atomic<long> cacheevictions;
+std::atomic<long> diskhits;
+// Set when we must stop early. Tasks then finish their current solve, and
+// start no more.
+std::atomic<bool> interrupted;
+// Number of tasks that were cut short (or never started) as a result.
+std::atomic<long> stoppedEarly;
+
+/* SIGINT and SIGUSR1 both stop the run early, and the solutions found so far
+ * are written out. A second SIGINT kills us outright. */
+static void onSignal(int sig) {
+  interrupted = true;
+  std::signal(sig, SIG_DFL);
+}
+
+#ifdef COUNT_ALLOCATIONS
+// Count every heap allocation, to see how much work the allocator is doing.
+std::atomic<long> allocations(0);
+
+void * operator new(std::size_t size) {
+  allocations++;
+  void * p = std::malloc(size ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void * p) noexcept {
+  std::free(p);
+}
+#endif
+
+/* Read the tolerances for an approximate front: either one for every
+ * objective, or a comma-separated list with one per objective. Each is a
+ * non-negative number, and is relative (a percentage) if it ends in %. */
+static bool parseEpsilon(const std::string & arg, int objcnt, Options & opts) {
+  std::vector<double> values;
+  std::vector<char> relative;
+  std::stringstream ss(arg);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    bool percent = (! item.empty()) && (item.back() == '%');
+    if (percent)
+      item.pop_back();
+    char * end;
+    double value = std::strtod(item.c_str(), &end);
+    if (item.empty() || (*end != '\0') || (value < 0) || (value > 1e9))
+      return false;
+    values.push_back(value);
+    relative.push_back(percent);
+  }
+  if (values.size() == 1) {
+    values.resize(objcnt, values[0]);
+    relative.resize(objcnt, relative[0]);
+  }
+  if (static_cast<int>(values.size()) != objcnt)
+    return false;
+  opts.epsilon = values;
+  opts.epsilonRelative = relative;
+  return true;
+}
 
 int main(int argc, char* argv[]) {
 
   int status = 0; /* Operation status */
   ipcount = 0;
+  ipnanos = 0;
+  poolharvested = mipstarts = 0;
+  cachehits = cachemisses = cacheevictions = diskhits = 0;
+  interrupted = false;
+  stoppedEarly = 0;
   Env e;
+  Options opts;
 
-  std::string pFilename, outputFilename;
+  std::string pFilename, outputFilename, relaxFilename, formatName;
+  std::string traceFilename, epsilonString, solveModeName, engineName;
+  std::string walkOrderName;
+  bool stream;
+  bool supported;
+  bool bounds;
 
-  int numSteps;
-  bool shareSolns;
+  double cacheMB;
+  double timeLimit;
   /* Timing */
   clock_t starttime, endtime;
   double cpu_time_used, elapsedtime, startelapsed;
@@ -69,16 +173,73 @@ int main(int argc, char* argv[]) {
       po::value<int>(&num_threads)->default_value(1),
      "Number of threads to use internally. Optional, default to 1.")
     ("steps,s",
-      po::value<int>(&numSteps)->default_value(1),
+      po::value<int>(&opts.numSteps)->default_value(1),
      "Number of steps to take along each objective function when splitting up the search space. Optional, default to 1.")
     ("share,r",
-     po::bool_switch(&shareSolns),
+     po::bool_switch(&opts.shareSolns),
      "Share solutions (and relaxations) across divisions of the solution space.")
+    ("cache-mb",
+      po::value<double>(&cacheMB)->default_value(0),
+     "Limit each store of relaxations (including its lookup grid) to this many megabytes, evicting the least recently used relaxations when full. Optional, default to 0 (no limit).")
+    ("grid-cells",
+      po::value<size_t>(&opts.gridCells)->default_value(opts.gridCells),
+     "Use a dense grid to look up relaxations inside any box with at most this many integer points. Optional, default to 262144. 0 disables the grid.")
+    ("cache-file",
+      po::value<std::string>(&relaxFilename),
+     "Keep relaxations in this file, and reuse them in later runs on the same problem. Optional.")
+    ("stats",
+     po::bool_switch(&opts.stats),
+     "Write extra statistics (e.g. relaxation cache hit rates) to the output file.")
+    ("format",
+      po::value<std::string>(&formatName)->default_value("tsv"),
+     "Format of the solutions in the output file: tsv, csv, jsonl or binary. Optional, default to tsv.")
+    ("time-limit",
+      po::value<double>(&timeLimit)->default_value(0),
+     "Stop after this many seconds, and write the solutions found so far. SIGINT and SIGUSR1 do the same. Optional, default to 0 (no limit).")
+    ("epsilon",
+      po::value<std::string>(&epsilonString),
+     "Find an approximate front. Each point of the exact front is then at most this much better than some point found, in each objective. Give one tolerance, or one per objective separated by commas. A tolerance ending in % is relative to the objective value; it needs an objective that cannot be negative, and must be below 100% when minimising. Optional, default to an exact front.")
+    ("engine",
+      po::value<std::string>(&engineName)->default_value("auto"),
+     "How to search for the front: kppm (the general method), balanced-box (for problems with two objectives), defining-point (search every objective at once, for many objectives) or auto (balanced-box for an exact front of two objectives when no option of the kppm engine is given, otherwise kppm). Optional, default to auto.")
+    ("solve-mode",
+      po::value<std::string>(&solveModeName)->default_value("sequential"),
+     "How to find each lexicographic optimum: sequential (one IP per objective), native (one call to the multi-objective solver of CPLEX 12.9 or later) or augmented (one IP over a weighted sum of the objectives, if the objectives are bounded). Optional, default to sequential.")
+    ("walk-order",
+      po::value<std::string>(&walkOrderName)->default_value("fixed"),
+     "The order in which each walk takes its objectives: fixed (by objective index) or range (chosen from the ranges the lower levels found, optimising the widest objective and walking the narrowest innermost). With --trace, each chosen order is noted in the trace file. Optional, default to fixed.")
+    ("harvest-pool",
+      po::value<int>(&opts.harvestPool)->default_value(0),
+     "After each IP, keep up to this many solutions from the CPLEX solution pool, and use them as starting solutions for later IPs that they are feasible for. Optional, default to 0 (off).")
+    ("cutoff",
+     po::bool_switch(&opts.cutoff),
+     "Before each IP, give CPLEX an objective cutoff from the solutions already found that are feasible for it, and the best of them as a starting solution.")
+    ("lp-screen",
+      po::value<long>(&opts.lpScreen)->default_value(0),
+     "Before each IP, spend up to this many dual simplex iterations on its LP relaxation, and skip the IP if the relaxation is infeasible. Optional, default to 0 (off).")
+    ("bounds",
+     po::bool_switch(&bounds),
+     "Before anything else, find the best and worst value of each objective over the feasible set, in parallel. These then replace infinite bounds on the objectives, and IPs that ask for better than the best values are skipped.")
+    ("supported",
+     po::bool_switch(&supported),
+     "Before the kppm engine starts, find the extreme supported points of each pair of objectives with a dichotomic search over weighted sums. These are written straight away, and the walks start out knowing them.")
+    ("trace",
+      po::value<std::string>(&traceFilename),
+     "Record the hypervolume of the solutions found so far in this file, each time it grows. Optional.")
+    ("stream",
+     po::bool_switch(&stream),
+     "Write each solution to the output file as soon as it is known to be nondominated, rather than at the end.")
   ;
 
   po::store(po::parse_command_line(argc, argv, opt), v);
   po::notify(v);
 
+  if (cacheMB < 0) {
+    std::cerr << "Error: The relaxation cache limit cannot be negative." << std::endl;
+    return(1);
+  }
+  opts.cacheBytes = static_cast<size_t>(cacheMB * 1024 * 1024);
+
   if (v.count("help")) {
     // usage();
     std::cout << "k-PPM at " << HASH << std::endl;
@@ -100,6 +261,57 @@ int main(int argc, char* argv[]) {
     return(1);
   }
 
+  if (opts.harvestPool < 0) {
+    std::cerr << "Error: --harvest-pool cannot be negative." << std::endl;
+    return(1);
+  }
+
+  if (opts.lpScreen < 0) {
+    std::cerr << "Error: --lp-screen cannot be negative." << std::endl;
+    return(1);
+  }
+
+  if (timeLimit < 0) {
+    std::cerr << "Error: The time limit cannot be negative." << std::endl;
+    return(1);
+  }
+
+  if (solveModeName == "sequential") {
+    opts.solveMode = SEQUENTIAL;
+  } else if (solveModeName == "native") {
+#if CPX_VERSION >= 12090000
+    opts.solveMode = NATIVE;
+#else
+    std::cerr << "Warning: This CPLEX has no multi-objective solver, solving sequentially." << std::endl;
+#endif
+  } else if (solveModeName == "augmented") {
+    opts.solveMode = AUGMENTED;
+  } else {
+    std::cerr << "Error: Unknown solve mode " << solveModeName << "." << std::endl;
+    return(1);
+  }
+
+  if (walkOrderName == "fixed") {
+    opts.walkOrder = FIXED;
+  } else if (walkOrderName == "range") {
+    opts.walkOrder = RANGE;
+  } else {
+    std::cerr << "Error: Unknown walk order " << walkOrderName << "." << std::endl;
+    return(1);
+  }
+
+  if ((engineName != "auto") && (engineName != "kppm") &&
+      (engineName != "balanced-box") && (engineName != "defining-point")) {
+    std::cerr << "Error: Unknown engine " << engineName << "." << std::endl;
+    return(1);
+  }
+
+  ResultWriter::Format format;
+  if (! ResultWriter::parseFormat(formatName, format)) {
+    std::cerr << "Error: Unknown output format " << formatName << "." << std::endl;
+    return(1);
+  }
+
 
   /* Start the timer */
   starttime = clock();
@@ -113,14 +325,140 @@ int main(int argc, char* argv[]) {
   Problem p(pFilename.c_str(), e);
 
   int objCount = p.objcnt;
+  opts.lattice.assign(p.objgcd, p.objgcd + objCount);
+  if (v.count("epsilon") && (! parseEpsilon(epsilonString, objCount, opts))) {
+    std::cerr << "Error: --epsilon needs one non-negative tolerance, or one for each of the " << objCount << " objectives." << std::endl;
+    return(1);
+  }
+  // A relative tolerance is a fraction of the value reached, which only
+  // bounds the ratio between points when no value is negative.
+  for (size_t o = 1; o < opts.epsilon.size(); ++o) {
+    if (! opts.epsilonRelative[o])
+      continue;
+    if (p.objlb[o] < 0) {
+      std::cerr << "Error: A relative --epsilon needs objective " << o << " to be non-negative, but its variable bounds allow it to be negative." << std::endl;
+      return(1);
+    }
+    if ((p.objsen == MIN) && (opts.epsilon[o] >= 100)) {
+      std::cerr << "Error: A relative --epsilon must be below 100% when minimising." << std::endl;
+      return(1);
+    }
+  }
+  // Options that only the kppm engine uses. If any is given, auto picks
+  // kppm, and the other engines say that they ignore it.
+  static const char * kppmOnly[] = { "steps", "share", "cache-mb",
+    "cache-file", "solve-mode", "walk-order", "harvest-pool", "cutoff",
+    "lp-screen", "supported" };
+  std::vector<std::string> kppmGiven;
+  for (auto name: kppmOnly) {
+    if (v.count(name) && (! v[name].defaulted()))
+      kppmGiven.push_back(name);
+  }
+  bool balanced = (engineName == "balanced-box") ||
+    ((engineName == "auto") && (objCount == 2) && opts.epsilon.empty() &&
+     kppmGiven.empty());
+  if (balanced && (objCount != 2)) {
+    std::cerr << "Error: The balanced-box engine needs exactly two objectives." << std::endl;
+    return(1);
+  }
+  bool defining = (engineName == "defining-point");
+  if ((balanced || defining) && (! opts.epsilon.empty())) {
+    std::cerr << "Error: --epsilon needs the kppm engine." << std::endl;
+    return(1);
+  }
+  if (balanced || defining) {
+    for (auto & name: kppmGiven) {
+      std::cerr << "Warning: --" << name << " needs the kppm engine, and is ignored." << std::endl;
+    }
+    supported = false;
+    opts.walkOrder = FIXED;
+    opts.solveMode = SEQUENTIAL;
+  }
+  outFile.open(outputFilename, std::ios::binary);
+  if (! outFile) {
+    std::cerr << "Error: Could not open output file " << outputFilename << "." << std::endl;
+    return(1);
+  }
+  ResultWriter writer(outFile, format, objCount, stream, HASH);
+  Trace * trace = nullptr;
+  if (v.count("trace")) {
+    trace = new Trace(traceFilename, objCount, p.objsen);
+    if (trace->valid()) {
+      opts.trace = trace;
+    }
+  }
+  if (defining && (opts.trace != nullptr)) {
+    std::cerr << "Warning: The defining-point engine does not know the bounds of the front in advance, so --trace is ignored." << std::endl;
+    opts.trace = nullptr;
+  }
+  RelaxationFile * relaxFile = nullptr;
+  if (v.count("cache-file") && (! balanced) && (! defining)) {
+    relaxFile = new RelaxationFile(relaxFilename, pFilename, objCount);
+    if (relaxFile->valid()) {
+      opts.relaxFile = relaxFile;
+    }
+  }
   JobServer server(num_threads);
+
+  std::signal(SIGINT, onSignal);
+  std::signal(SIGUSR1, onSignal);
+  std::mutex finishedMutex;
+  std::condition_variable finishedCond;
+  bool finished = false;
+  std::thread watchdog;
+  if (timeLimit > 0) {
+    watchdog = std::thread([&] {
+        std::unique_lock<std::mutex> lock(finishedMutex);
+        if (! finishedCond.wait_for(lock,
+              std::chrono::duration<double>(timeLimit),
+              [&finished] { return finished; }))
+          interrupted = true;
+        });
+  }
+
+  if (bounds) {
+    std::vector<BoundTask *> boundTasks;
+    std::vector<std::future<Status> > found;
+    for (int i = 0; i < objCount; ++i) {
+      BoundTask * t = new BoundTask(pFilename, objCount, p.objsen, i);
+      boundTasks.push_back(t);
+      found.push_back(server.q(t));
+    }
+    for (auto & f: found) {
+      f.wait();
+    }
+    for (auto t: boundTasks) {
+      opts.ideal.push_back(t->ideal());
+      opts.worst.push_back(t->worst());
+      delete t;
+    }
+    // Also tightens the zones of the defining point method, which start
+    // from our right-hand sides.
+    p.restrict(e, opts.ideal.data(), opts.worst.data());
+  }
+  // With the bounds above, more problems can be weighted exactly.
+  if (opts.solveMode == AUGMENTED) {
+    // Each task weights a subset of these, in this order, so if these
+    // weights are safe then so are theirs.
+    std::vector<int> all(objCount);
+    std::vector<double> weights(objCount);
+    for (int i = 0; i < objCount; ++i) {
+      all[i] = i;
+    }
+    if (! p.lexicographic_weights(all.data(), objCount, weights.data())) {
+      std::cerr << "Warning: The objectives are unbounded or too large to weight exactly, solving sequentially." << std::endl;
+      opts.solveMode = SEQUENTIAL;
+    }
+  }
   int * objectives = new int[objCount];
   std::vector<std::vector<P1Task *> *> allTasks;
   for(int i = 0; i < objCount; ++i) {
     allTasks.push_back(new std::vector<P1Task *>);
   }
   std::queue<P1Task *> addPreReqs;
-  for(int i = 1; i < (1 << objCount); ++i) {
+  // The other engines need none of these levels.
+  bool kppm = (! balanced) && (! defining);
+  for(int i = kppm ? 1 : (1 << objCount); i < (1 << objCount); ++i) {
     int numAdded = 0;
     for(int j = 0; j < objCount; ++j) {
       int isInSet = (int) i & 1 << j;
@@ -130,7 +468,7 @@ int main(int argc, char* argv[]) {
       }
     }
     P1Task *t = new P1Task(pFilename, numAdded, p.objcnt, p.objsen, objectives,
-        numSteps, shareSolns, &server);
+        &opts, &server);
     allTasks[numAdded-1]->push_back(t);
     addPreReqs.push(t);
   }
@@ -180,24 +518,92 @@ int main(int argc, char* argv[]) {
   }
 
   // Create final grouping task
-  Task * g = new Gather(pFilename, objCount, objectives, p.objsen);
+  for(int i = 0; i < objCount; ++i) {
+    objectives[i] = i;
+  }
+  Gather * g = new Gather(pFilename, objCount, objectives, p.objsen,
+      stream ? &writer : nullptr, opts.trace);
   for(auto t: *allTasks[objCount-1]) {
     t->addNextLevel(g);
     g->addPreReq(t);
   }
+  BalancedBoxTask * front = nullptr;
+  if (balanced) {
+    front = new BalancedBoxTask(pFilename, p.objsen, &opts, &server);
+    front->addNextLevel(g);
+    g->addPreReq(front);
+  }
+  std::vector<DefiningPointTask *> workers;
+  if (defining) {
+    // One worker per thread, all sharing one search region.
+    auto region = std::make_shared<SearchRegion>(objCount, p.objsen,
+        opts.lattice, p.rhs);
+    for (int i = 0; i < num_threads; ++i) {
+      DefiningPointTask * w = new DefiningPointTask(pFilename, objCount,
+          objectives, p.objsen, region);
+      g->addPreReq(w);
+      workers.push_back(w);
+    }
+  }
+
+  // The supported points go to g, and also to a sink of their own, which
+  // the walks of the top level wait for.
+  std::vector<SupportedTask *> pairs;
+  Gather * sink = nullptr;
+  if (supported) {
+    sink = new Gather(pFilename, objCount, objectives, p.objsen);
+    for (int i = 0; i < objCount; ++i) {
+      for (int j = i + 1; j < objCount; ++j) {
+        SupportedTask * t = new SupportedTask(pFilename, objCount, p.objsen,
+            i, j, &server);
+        t->addNextLevel(sink);
+        sink->addPreReq(t);
+        t->addNextLevel(g);
+        g->addPreReq(t);
+        pairs.push_back(t);
+      }
+    }
+  }
   std::vector<std::future<Status> > results;
-  for(auto l: allTasks) {
-    for(Task *t: *l) {
+  for(auto t: pairs) {
+    results.push_back(server.q(t));
+  }
+  // The lower levels do not need the supported points, so they can start
+  // while the search runs.
+  for(int i = 0; i < objCount - 1; ++i) {
+    for(Task *t: *allTasks[i]) {
       results.push_back(server.q(t));
     }
   }
+  if (sink != nullptr) {
+    server.q(sink).wait();
+    for (const int * s: sink->solutions()) {
+      opts.supported.insert(opts.supported.end(), s, s + objCount);
+    }
+  }
+  for(Task *t: *allTasks[objCount - 1]) {
+    results.push_back(server.q(t));
+  }
 
+  if (front != nullptr)
+    results.push_back(server.q(front));
+  for(auto w: workers) {
+    results.push_back(server.q(w));
+  }
   results.push_back(server.q(g));
 
   delete[] objectives;
   for(auto & jobs: results) {
     jobs.wait();
   }
+  if (watchdog.joinable()) {
+    {
+      std::unique_lock<std::mutex> lock(finishedMutex);
+      finished = true;
+    }
+    finishedCond.notify_one();
+    watchdog.join();
+  }
 
   for(auto l: allTasks) {
     for(Task *t: *l) {
@@ -205,6 +611,18 @@ int main(int argc, char* argv[]) {
     }
     delete l;
   }
+  delete front;
+  for(auto t: pairs) {
+    delete t;
+  }
+  delete sink;
+  for(auto w: workers) {
+    delete w;
+  }
+  delete relaxFile;
+  if (opts.trace != nullptr)
+    opts.trace->finish();
+  delete trace;
   /* Stop the clock. Sort and print results.*/
   endtime = clock();
   cpu_time_used=((double) (endtime - starttime)) / CLOCKS_PER_SEC;
@@ -213,18 +631,54 @@ int main(int argc, char* argv[]) {
 
   constexpr int width = 8;
   constexpr int precision = 3;
-  outFile.open(outputFilename);
-  outFile << std::endl << "Using k-PPM at " << HASH << std::endl;
-  g->cleanSolutions();
-  g->dumpSolutions(outFile);
-  outFile << std::endl << "---" << std::endl;
+  g->writeRemaining(writer);
+  Summary summary;
   int solCount = g->solutions().size();
-  outFile << cpu_time_used << " CPU seconds" << std::endl;
-  outFile << std::setw(width) << std::setprecision(precision) << std::fixed;
-  outFile << elapsedtime << " elapsed seconds" << std::endl;
-  outFile << std::setw(width) << std::setprecision(precision) << std::fixed;
-  outFile << ipcount << " IPs solved" << std::endl;
-  outFile << std::setw(width) << std::setprecision(precision) << std::fixed;
-  outFile << solCount << " Solutions found" << std::endl;
+  summary.add(cpu_time_used, " CPU seconds", -1);
+  summary.add(elapsedtime, " elapsed seconds", precision, width);
+  summary.add(ipcount, " IPs solved", 0, width);
+  summary.add(solCount, " Solutions found", 0, width);
+  // The first objective is never walked, so it is always exact.
+  for (size_t o = 1; o < opts.epsilon.size(); ++o) {
+    if (opts.epsilonRelative[o]) {
+      // A walk skips points up to epsilon percent of the value it reached
+      // better than that value, which is a ratio of 1 / (1 - epsilon) when
+      // minimising, and of 1 + epsilon when maximising.
+      double eps = opts.epsilon[o] / 100;
+      summary.add((p.objsen == MIN) ? 1 / (1 - eps) : 1 + eps,
+          " approximation factor on objective " + std::to_string(o), -1);
+    } else {
+      summary.add(static_cast<int>(opts.epsilon[o]),
+          " additive tolerance on objective " + std::to_string(o));
+    }
+  }
+  if (stoppedEarly > 0) {
+    summary.add(stoppedEarly, " tasks stopped early (the front is incomplete)");
+  }
+  if (opts.stats) {
+    long lookups = cachehits + cachemisses;
+    summary.add(cachehits, " relaxation cache hits");
+    summary.add(cachemisses, " relaxation cache misses");
+    summary.add(lookups > 0 ? 100.0 * cachehits / lookups : 0.0,
+        "% relaxation cache hit rate", 1);
+    summary.add(cacheevictions, " relaxations evicted");
+    summary.add(diskhits, " relaxations read from cache file");
+    summary.add(poolharvested, " pool solutions kept as witnesses");
+    summary.add(mipstarts, " MIP starts given");
+    summary.add(opts.supported.size() / objCount, " supported points found before the walks");
+    summary.add(weightedskipped, " weighted sums too large to solve exactly");
+    summary.add(cutoffs, " objective cutoffs given");
+    summary.add(lpscreens, " LP relaxations screened");
+    summary.add(lpscreened, " IPs avoided by LP screening");
+    summary.add(idealskipped, " IPs avoided by the ideal point");
+    summary.add(ipnodes, " branch-and-bound nodes in walk IPs");
+    summary.add(walkips > 0 ? static_cast<double>(ipnodes) / walkips : 0.0,
+        " nodes per walk IP", 1);
+    summary.add(ipnanos / 1e9, " seconds in walk IPs (all threads)", 3);
+#ifdef COUNT_ALLOCATIONS
+    summary.add(allocations, " heap allocations");
+#endif
+  }
+  writer.finish(summary);
   return 0;
 }
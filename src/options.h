@@ -0,0 +1,152 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <cstddef>
+#include <vector>
+
+class RelaxationFile;
+class Trace;
+
+/**
+ * How a P3Task finds the lexicographic optimum at each point of its walk.
+ * SEQUENTIAL - one MIP per objective, fixing each optimum in turn.
+ * NATIVE - one call to the multi-objective solver of CPLEX 12.9 or later.
+ * AUGMENTED - one MIP over a weighted sum of the objectives, with weights
+ *   large enough to respect their priorities.
+ */
+enum SolveMode { SEQUENTIAL, NATIVE, AUGMENTED };
+
+/**
+ * The order in which a P3Task takes its objectives.
+ * FIXED - the order of the lattice, by objective index.
+ * RANGE - chosen for each P3Creator from the ranges that the lower levels
+ *   found: the widest objective is optimised and never walked, and the rest
+ *   are walked with the narrowest innermost.
+ */
+enum WalkOrder { FIXED, RANGE };
+
+/**
+ * Run-wide settings. These are filled in by main() from the command line, and
+ * are then only read by the tasks.
+ */
+class Options {
+  public:
+    /**
+     * Number of steps to take along each objective dimension when splitting
+     * the objective search space.
+     */
+    int numSteps;
+
+    /**
+     * Share solutions (and relaxations) across all P3Tasks created by a
+     * single P3Creator.
+     */
+    bool shareSolns;
+
+    /**
+     * Upper limit, in bytes, on the size of each relaxation store. Once a
+     * store is full, the least recently hit relaxations are evicted. 0 means
+     * no limit.
+     */
+    size_t cacheBytes;
+
+    /**
+     * Largest number of cells for the dense grid that a P3Task puts over its
+     * box to speed up relaxation lookups. Boxes with a larger volume only
+     * use the list of relaxations. 0 disables the grid.
+     */
+    size_t gridCells;
+
+    /**
+     * Tolerance on each objective (by objective index) for an approximate
+     * front. Once a point is found, the walk skips every point that is at
+     * most this much better in the walked objective. If epsilonRelative is
+     * set for an objective, its tolerance is a percentage of the value
+     * reached. Only the tasks with every objective use these, as the lower
+     * levels bound the search boxes. Empty for an exact front.
+     */
+    std::vector<double> epsilon;
+    std::vector<char> epsilonRelative;
+
+    /**
+     * Every value that objective i can take is a multiple of lattice[i], so
+     * walks and bounds only need to visit these.
+     */
+    std::vector<int> lattice;
+
+    /**
+     * Write extra statistics at the end of the output file.
+     */
+    bool stats;
+
+    /**
+     * Relaxations kept on disk across runs, or nullptr if not used.
+     */
+    RelaxationFile * relaxFile;
+
+    /**
+     * Where to record how the front converges, or nullptr if not used.
+     */
+    Trace * trace;
+
+    SolveMode solveMode;
+
+    WalkOrder walkOrder;
+
+    /**
+     * After each IP, keep up to this many solutions from the solution pool
+     * of CPLEX as feasible starts for later IPs. 0 turns this off.
+     */
+    int harvestPool;
+
+    /**
+     * Before each IP, give CPLEX a cutoff from the results already stored,
+     * and the best known solution that is feasible for it as a start.
+     */
+    bool cutoff;
+
+    /**
+     * Before each IP, spend up to this many dual simplex iterations on its
+     * LP relaxation, and skip the IP if that is infeasible. 0 turns this
+     * off.
+     */
+    long lpScreen;
+
+    /**
+     * Extreme supported points found before the walks start, one after
+     * another, with a value for every objective. The tasks with every
+     * objective start out knowing these.
+     */
+    std::vector<int> supported;
+
+    /**
+     * The best and worst value of each objective over the feasible set, by
+     * objective index, if these were found before the search. Empty
+     * otherwise.
+     */
+    std::vector<double> ideal;
+    std::vector<double> worst;
+
+    Options();
+};
+
+inline Options::Options() : numSteps(1), shareSolns(false), cacheBytes(0),
+    gridCells(1 << 18), stats(false), relaxFile(nullptr), trace(nullptr),
+    solveMode(SEQUENTIAL), walkOrder(FIXED), harvestPool(0), cutoff(false),
+    lpScreen(0) {
+}
+
+#endif /* OPTIONS_H */
@@ -16,6 +16,7 @@ You should have received a copy of the GNU General Public License along with thi
 #include <cmath>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #include "types.h"
 #include "p1task.h"
@@ -35,15 +36,18 @@ Status P1Task::operator()() {
   debug_mutex.unlock();
 #endif
   int dim = objCount_ - 1;
-  int numBlocks = pow(numSteps_,dim);
+  int numBlocks = pow(opts_->numSteps,dim);
   std::list<P2Task *> tasks;
   gatherSolutions();
   if (objCount_ == 1) {
-    double ** bounds = new double*[2];
-    bounds[0] = new double[1];
-    bounds[1] = new double[1];
-    bounds[0][0] = -INF;
-    bounds[1][0] = INF;
+    double lower[1] = { -INF };
+    double upper[1] = { INF };
+    if (! opts_->ideal.empty()) {
+      int o = objectives_[0];
+      lower[0] = (sense_ == MIN) ? opts_->ideal[o] : opts_->worst[o];
+      upper[0] = (sense_ == MIN) ? opts_->worst[o] : opts_->ideal[o];
+    }
+    double * bounds[2] = { lower, upper };
     P2Task * p = new P2Task(bounds, filename_, objCount_, objCountTotal_, objectives_, sense_);
     for(auto n: nextLevel_) {
       n->addPreReq(p);
@@ -59,7 +63,7 @@ Status P1Task::operator()() {
     }
     for (int i = 0; i < objCount_; ++i) {
       int o = objectives_[i];
-      for (int *s : solutions()) {
+      for (const int *s : solutions()) {
         if (s[o] > maxOverall[i])
           maxOverall[i] = s[o];
         if (s[o] < minOverall[i])
@@ -80,18 +84,19 @@ Status P1Task::operator()() {
     std::cout << "]" << std::endl;
     debug_mutex.unlock();
 #endif
+    // Each P2Task copies its bounds, so one set is reused for every block.
+    std::vector<double> lower(objCount_), upper(objCount_);
+    double * bounds[2] = { lower.data(), upper.data() };
     for (int b = 0; b < numBlocks; ++b) {
       int temp = b;
-      double ** bounds = new double*[2];
-      bounds[0] = new double[objCount_];
-      bounds[1] = new double[objCount_];
+      bool empty = false;
       for (int d = 1; d < objCount_; ++d) {
         int o = objectives_[d];
         double max = maxOverall[d];
         double min = minOverall[d];
         // Find max and min values reached that also satisfy this particular
         // bound so far
-        for ( int *s : solutions()) {
+        for ( const int *s : solutions()) {
           bool valid = true;
           // For all dimensions up to this one
           for (int d_ = 1; d_ < d; ++d_) {
@@ -121,16 +126,29 @@ Status P1Task::operator()() {
               min = s[o];
           }
         }
-        double stepSize = (max - min) / (numSteps_);
-        bounds[0][d] = min + (temp % numSteps_)*stepSize;
-        bounds[1][d] = min + (temp % numSteps_ + 1)*stepSize;
-        temp = temp / numSteps_;
+        double stepSize = (max - min) / (opts_->numSteps);
+        bounds[0][d] = min + (temp % opts_->numSteps)*stepSize;
+        bounds[1][d] = min + (temp % opts_->numSteps + 1)*stepSize;
+        temp = temp / opts_->numSteps;
+        // Only multiples of g can be reached, so shrink the block to them. A
+        // block with none is skipped, as its IP would be infeasible.
+        int g = opts_->lattice.empty() ? 1 : opts_->lattice[o];
+        if (g > 1) {
+          bounds[0][d] = std::ceil(bounds[0][d] / g) * g;
+          bounds[1][d] = std::floor(bounds[1][d] / g) * g;
+          if (bounds[0][d] > bounds[1][d])
+            empty = true;
+        }
       }
+      if (empty)
+        continue;
       P2Task * p = new P2Task(bounds, filename_, objCount_, objCountTotal_, objectives_, sense_);
       tasks.push_back(p);
     }
     P3Creator * p3c = new P3Creator(filename_, objCount_, objCountTotal_,
-        objectives_, sense_, shareSolns_, minOverall, maxOverall, taskServer_);
+        objectives_, sense_, opts_, minOverall, maxOverall, taskServer_);
+    delete[] maxOverall;
+    delete[] minOverall;
     for (auto n: nextLevel_) {
       n->addPreReq(p3c);
       p3c->addNextLevel(n);
@@ -142,7 +160,7 @@ Status P1Task::operator()() {
     }
     taskServer_->q(p3c);
   }
-  status_ = DONE;
+  done();
 #ifdef DEBUG
   debug_mutex.lock();
   std::cout << *this << " done." << std::endl;
@@ -20,13 +20,14 @@ You should have received a copy of the GNU General Public License along with thi
 #include "sense.h"
 #include "task.h"
 #include "jobserver.h"
+#include "options.h"
 
 class P2Task;
 
 class P1Task: public Task {
   public:
     P1Task(std::string & problem, int objCount, int objCountTotal, Sense sense,
-        int * objectives, int numSteps, bool shareSolns, JobServer *taskServer);
+        int * objectives, const Options * opts, JobServer *taskServer);
 
     void addNextLevel(Task * nextLevel);
     Status operator()();
@@ -35,25 +36,17 @@ class P1Task: public Task {
     virtual std::string details() const;
 
   private:
-    /**
-     * Number of steps to take along each objective dimension when splitting
-     * the objective search space. For instance, a 3-objective problem with 2
-     * steps would result in a 2x2 square along one objective, or 4 separate
-     * columns to search.
-     */
-    int numSteps_;
-
-    bool shareSolns_;
+    const Options * opts_;
 
     JobServer * taskServer_;
     std::list<Task *> nextLevel_;
 };
 
 inline P1Task::P1Task(std::string & filename, int objCount, int objCountTotal,
-    Sense sense, int * objectives, int numSteps, bool shareSolns,
+    Sense sense, int * objectives, const Options * opts,
     JobServer *taskServer) :
     Task(filename, objCount, objCountTotal, objectives, sense),
-    numSteps_(numSteps), shareSolns_(shareSolns), taskServer_(taskServer) {
+    opts_(opts), taskServer_(taskServer) {
 
 }
 
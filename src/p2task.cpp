@@ -25,6 +25,8 @@ You should have received a copy of the GNU General Public License along with thi
 #include "types.h"
 
 extern std::atomic<int> ipcount;
+extern std::atomic<bool> interrupted;
+extern std::atomic<long> stoppedEarly;
 
 #ifdef DEBUG
 extern std::mutex debug_mutex;
@@ -33,6 +35,11 @@ extern std::mutex debug_mutex;
 
 Status P2Task::operator()() {
   status_ = RUNNING;
+  if (interrupted) {
+    stoppedEarly++;
+    done();
+    return status_;
+  }
 #ifdef DEBUG
   debug_mutex.lock();
   std::cout << details();
@@ -129,7 +136,8 @@ Status P2Task::operator()() {
 
   solnstat = CPXgetstat (e.env, e.lp);
   if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD)) {
-    status_ = DONE;
+    delete[] sol;
+    done();
     return status_;
   }
   status = CPXXgetobjval (e.env, e.lp, &sol[o]);
@@ -146,7 +154,9 @@ Status P2Task::operator()() {
     ipcount++;
     solnstat = CPXgetstat (e.env, e.lp);
     if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD)) {
-      return status_ = DONE;
+      delete[] sol;
+      done();
+      return status_;
     }
     status = CPXXgetobjval (e.env, e.lp, &sol[o]);
     if ( status ) {
@@ -171,11 +181,10 @@ Status P2Task::operator()() {
   delete[] soln;
   CPXfreeprob(e.env, &e.lp);
   CPXcloseCPLEX(&e.env);
-  int * n = new int[objCountTotal_];
+  int * n = newSolution();
   for (int i = 0; i < objCountTotal_; ++i) {
     n[i] = round(sol[i]);
   }
-  solutions_.push_back(n);
 
 #ifdef DEBUG
   debug_mutex.lock();
@@ -191,7 +200,7 @@ Status P2Task::operator()() {
 #endif
 
   delete[] sol;
-  status_ = DONE;
+  done();
   return status_;
 }
 
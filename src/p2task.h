@@ -26,11 +26,13 @@ class P2Task : public Task {
   public:
     P2Task(double **bound, std::string & filename, int objCount,
         int objCountTotal, int * objectives, Sense sense);
+    ~P2Task();
     Status operator()();
 
 
     virtual std::string str() const;
     virtual std::string details() const;
+    virtual bool certified() const;
   private:
     double **bounds_;
     int obj_;
@@ -48,5 +50,17 @@ inline P2Task::P2Task(double **bound, std::string & filename, int objCount,
   }
 }
 
+inline P2Task::~P2Task() {
+  delete[] bounds_[0];
+  delete[] bounds_[1];
+  delete[] bounds_;
+}
+
+/* We only optimise one objective, so our solution is only certain to be
+ * nondominated if there are no others. */
+inline bool P2Task::certified() const {
+  return objCountTotal_ == 1;
+}
+
 #endif /* P2TASK_H */
 
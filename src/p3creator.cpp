@@ -11,6 +11,8 @@ You should have received a copy of the GNU General Public License along with thi
 
 */
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <sstream>
 
@@ -21,6 +23,7 @@ You should have received a copy of the GNU General Public License along with thi
 #include "env.h"
 #include "problem.h"
 #include "solutions.h"
+#include "trace.h"
 #include "types.h"
 
 #ifdef DEBUG
@@ -28,16 +31,71 @@ extern std::mutex debug_mutex;
 #endif
 
 
+/* Pick the order our P3Tasks take our objectives in, as positions in
+ * objectives_. Roughly, a walk solves one IP per point of the box of its
+ * walked objectives, so the widest objective is the one left unwalked. The
+ * rest go from narrowest to widest, as the innermost objective is walked the
+ * most often. With a tolerance, the unwalked objective is exact, so it stays
+ * where main() expects it. */
+void P3Creator::chooseOrder() {
+  order_.resize(objCount_);
+  for (int i = 0; i < objCount_; ++i) {
+    order_[i] = i;
+  }
+  if (opts_->walkOrder == FIXED)
+    return;
+  std::vector<double> range(objCount_);
+  for (int i = 0; i < objCount_; ++i) {
+    int o = objectives_[i];
+    int g = opts_->lattice.empty() ? 1 : opts_->lattice[o];
+    range[i] = (upper_[i] - lower_[i]) / g;
+  }
+  bool fixFirst = (! opts_->epsilon.empty()) && (objCount_ == objCountTotal_);
+  std::stable_sort(order_.begin() + (fixFirst ? 1 : 0), order_.end(),
+      [&range](int a, int b) {
+        return range[a] < range[b];
+      });
+  if (! fixFirst)
+    std::rotate(order_.begin(), order_.end() - 1, order_.end());
+  if (opts_->trace != nullptr) {
+    std::vector<int> objectives(objCount_);
+    for (int i = 0; i < objCount_; ++i) {
+      objectives[i] = objectives_[order_[i]];
+    }
+    opts_->trace->walkOrder(objectives.data(), objCount_);
+  }
+}
+
+/* A P3Task for box b, taking our objectives in the order of order_. Results
+ * hold every objective by its index, so only the box and the objectives
+ * need permuting. */
+P3Task * P3Creator::newTask(Box * b, std::shared_ptr<Solutions> s) {
+  std::vector<int> objectives(objCount_);
+  std::vector<double> lower(objCount_), upper(objCount_);
+  for (int i = 0; i < objCount_; ++i) {
+    objectives[i] = objectives_[order_[i]];
+    lower[i] = b->lower(order_[i]);
+    upper[i] = b->upper(order_[i]);
+  }
+  Box permuted(upper.data(), lower.data(), objectives.data(), objCount_);
+  return new P3Task(&permuted, filename_, objCount_, objCountTotal_,
+      objectives.data(), sense_, opts_, s);
+}
+
 Status P3Creator::operator()() {
   status_ = RUNNING;
+  // Our archive already holds only the nondominated solutions, in order.
   gatherSolutions();
-  cleanSolutions();
+  // With every objective, our box bounds the whole front.
+  if ((opts_->trace != nullptr) && (objCount_ == objCountTotal_))
+    opts_->trace->setBounds(objectives_, lower_, upper_);
 #ifdef DEBUG
   debug_mutex.lock();
   std::cout << details();
   debug_mutex.unlock();
 #endif
 
+  chooseOrder();
   std::vector<Task *> tasks;
   if (solutions().size() > 1) {
 #ifdef DEBUG
@@ -55,9 +113,12 @@ Status P3Creator::operator()() {
     debug_mutex.unlock();
 #endif
     BoxStore store(objCount_);
-    Solutions * s = nullptr;
-    if (shareSolns_) {
-      s = new Solutions(objCountTotal_);
+    // The shared store is owned jointly by the P3Tasks, and is freed once
+    // the last of them finishes.
+    std::shared_ptr<Solutions> s;
+    if (opts_->shareSolns) {
+      s = std::make_shared<Solutions>(objCountTotal_, sense_,
+          opts_->cacheBytes);
     }
     store.insert(new Box(upper_, lower_, objectives_, objCount_));
     for(auto s: solutions()) {
@@ -83,14 +144,19 @@ Status P3Creator::operator()() {
         store.remove(b);
       }
     }
-    for(auto b: store) {
+    // Largest boxes first, so that if we are stopped early, the solutions we
+    // have still span the whole front rather than one corner of it.
+    std::vector<Box *> boxes(store.begin(), store.end());
+    std::stable_sort(boxes.begin(), boxes.end(), [](Box * a, Box * b) {
+        return a->volume() > b->volume();
+        });
+    for(auto b: boxes) {
 #ifdef DEBUG
       debug_mutex.lock();
       std::cout << "P3 task with box " << b->str() << std::endl;
       debug_mutex.unlock();
 #endif
-      P3Task * p = new P3Task(b, filename_, objCount_, objCountTotal_, objectives_, sense_, s);
-      tasks.push_back(p);
+      tasks.push_back(newTask(b, s));
     }
   } else {
 #ifdef DEBUG
@@ -108,8 +174,7 @@ Status P3Creator::operator()() {
     debug_mutex.unlock();
 #endif
     Box * b = new Box(upper_, lower_, objectives_, objCount_);
-    P3Task * p = new P3Task(b, filename_, objCount_, objCountTotal_, objectives_, sense_);
-    tasks.push_back(p);
+    tasks.push_back(newTask(b, nullptr));
     delete b;
   }
 
@@ -123,7 +188,7 @@ Status P3Creator::operator()() {
     taskServer_->q(t);
   }
 
-  status_ = DONE;
+  done();
   return status_;
 }
 
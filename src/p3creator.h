@@ -18,16 +18,24 @@ You should have received a copy of the GNU General Public License along with thi
 #include <mutex>
 #endif
 
+#include <memory>
+#include <vector>
+
 #include "task.h"
 #include "env.h"
 #include "problem.h"
 #include "jobserver.h"
+#include "options.h"
+
+class Box;
+class P3Task;
+class Solutions;
 
 class P3Creator : public Task {
   public:
     P3Creator(std::string & filename, int objCount,
         int objCountTotal, int * objectives, Sense sense,
-        bool shareSolns, double * lower, double * upper,
+        const Options * opts, double * lower, double * upper,
         JobServer * taskServer);
     Status operator()();
 
@@ -36,20 +44,26 @@ class P3Creator : public Task {
     virtual std::string str() const;
     virtual std::string details() const;
   private:
+    void chooseOrder();
+    P3Task * newTask(Box * b, std::shared_ptr<Solutions> s);
+
     JobServer * taskServer_;
     std::list<Task *> nextLevel_;
 
-    bool shareSolns_;
+    const Options * opts_;
     double * lower_;
     double * upper_;
+    // The positions of our objectives, in the order our P3Tasks take them.
+    std::vector<int> order_;
 };
 
 inline P3Creator::P3Creator(std::string & filename, int objCount,
-    int objCountTotal, int * objectives, Sense sense, bool shareSolns,
+    int objCountTotal, int * objectives, Sense sense, const Options * opts,
     double * lower, double * upper,
     JobServer * taskServer) :
     Task(filename, objCount, objCountTotal, objectives, sense),
-    taskServer_(taskServer), shareSolns_(shareSolns) {
+    taskServer_(taskServer), opts_(opts) {
+  archive_ = new ParetoArchive(objCount_, objCountTotal_, sense_);
   lower_ = new double[objCount_];
   upper_ = new double[objCount_];
   for (int d = 0; d < objCount_; ++d) {
@@ -13,6 +13,7 @@ You should have received a copy of the GNU General Public License along with thi
 
 #include <atomic>
 #include <cmath>
+#include <ctime>
 #include <string>
 #include <sstream>
 
@@ -20,7 +21,9 @@ You should have received a copy of the GNU General Public License along with thi
 
 #include "p3task.h"
 #include "env.h"
+#include "kernels.h"
 #include "problem.h"
+#include "relaxfile.h"
 #include "solutions.h"
 #include "types.h"
 
@@ -29,22 +32,102 @@ extern std::mutex debug_mutex;
 #endif
 
 extern std::atomic<int> ipcount;
+extern std::atomic<long> ipnanos;
+extern std::atomic<long> poolharvested;
+extern std::atomic<long> mipstarts;
+extern std::atomic<long> walkips;
+extern std::atomic<long> ipnodes;
+extern std::atomic<long> cutoffs;
+extern std::atomic<long> lpscreens;
+extern std::atomic<long> lpscreened;
+extern std::atomic<long> idealskipped;
+extern std::atomic<bool> interrupted;
+extern std::atomic<long> stoppedEarly;
+
+/* Has the walk gone past the far side of the box? Only the walked
+ * objectives are checked, so objectives, lower and upper each start at the
+ * second objective of the task. */
+template <int K, Sense S>
+struct PastBoundary {
+  static bool run(const double * rhs, const int * result,
+      const int * objectives, const double * lower, const double * upper,
+      int count) {
+    const int n = kernelWidth<K>(count);
+    for (int i = 0; i < n; ++i) {
+      double stop = (S == MIN) ? lower[i] : upper[i];
+      if (looser<S>(stop, rhs[objectives[i]]))
+        return true;
+    }
+    // Alternatively, check if all results are past the boundary
+    for (int i = 0; i < n; ++i) {
+      if (S == MIN) {
+        if (result[objectives[i]] > lower[i])
+          return false;
+      } else {
+        if (rhs[objectives[i]] < upper[i])
+          return false;
+      }
+    }
+    return true;
+  }
+};
 
+/* Find the lexicographic optimum over our objectives under rhs, and fill in
+ * every objective of it in result. Returns the CPLEX MIP status. */
 int P3Task::solve(Env & e, Problem & p, int * result, double * rhs) {
+  timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int solnstat;
+  if (pastIdeal(p, rhs) || ((screen_ != NULL) && lpInfeasible(e, p, rhs))) {
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ipnanos += (end.tv_sec - start.tv_sec) * 1000000000L +
+      (end.tv_nsec - start.tv_nsec);
+    return CPXMIP_INFEASIBLE;
+  }
+  bool starts = (opts_->harvestPool > 0) || opts_->cutoff;
+  if (starts) {
+    const double * x = witnesses_.find(rhs, objectives_, objCount_);
+    if (x != nullptr)
+      addStart(e, p, x);
+  }
+  if (augmented_) {
+    solnstat = solveAugmented(e, p, result, rhs);
+#if CPX_VERSION >= 12090000
+  } else if (opts_->solveMode == NATIVE) {
+    solnstat = solveNative(e, p, result, rhs);
+#endif
+  } else {
+    solnstat = solveSequential(e, p, result, rhs);
+  }
+  // Our own optimum is the best start for the solves near it.
+  if (opts_->cutoff && (solnstat != CPXMIP_INFEASIBLE) &&
+      (solnstat != CPXMIP_INForUNBD))
+    witnesses_.insert(result, soln_.data(), CPXXgetnumcols(e.env, e.lp));
+  if (opts_->harvestPool > 0) {
+    harvest(e, p);
+  } else if (starts) {
+    int n = CPXXgetnummipstarts(e.env, e.lp);
+    if (n > 0)
+      CPXXdelmipstarts(e.env, e.lp, 0, n - 1);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  ipnanos += (end.tv_sec - start.tv_sec) * 1000000000L +
+    (end.tv_nsec - start.tv_nsec);
+  return solnstat;
+}
+
+int P3Task::solveSequential(Env & e, Problem & p, int * result,
+    double * rhs) {
 
   int cur_numcols, status, solnstat;
   double objval;
-  double * srhs;
-  srhs = new double[p.objcnt];
-
-
-  for(int i = 0; i < p.objcnt; ++i)
-    srhs[i] = rhs[i];
+  // Scratch space is kept between calls, so only the first solve allocates.
+  srhs_.assign(rhs, rhs + p.objcnt);
+  double * srhs = srhs_.data();
 
   cur_numcols = CPXXgetnumcols(e.env, e.lp);
-  bool * objectives_done = new bool[p.objcnt];
-  for(int i = 0; i < p.objcnt; ++i)
-    objectives_done[i] = false;
+  objectivesDone_.assign(p.objcnt, false);
+  std::vector<char> & objectives_done = objectivesDone_;
 
   for (int pre_j = 0; pre_j < objCount_; pre_j++) {
     int j = objectives_[pre_j];
@@ -59,9 +142,13 @@ int P3Task::solve(Env & e, Problem & p, int * result, double * rhs) {
       std::cerr << "Failed to change constraint srhs" << std::endl;
     }
 
+    if (opts_->cutoff) {
+      double one = 1;
+      cutoff(e, p, srhs, &j, &one, 1);
+    }
+
     /* solve for current objective*/
-    status = CPXXmipopt (e.env, e.lp);
-    ipcount++;
+    status = mipopt(e);
     if (status) {
       std::cerr << "Failed to optimize LP." << std::endl;
     }
@@ -80,8 +167,7 @@ int P3Task::solve(Env & e, Problem & p, int * result, double * rhs) {
         p.mip_tolerance /= 10;
       }
       CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_MIPGap, p.mip_tolerance);
-      status = CPXmipopt (e.env, e.lp);
-      ipcount++;
+      status = mipopt(e);
       solnstat = CPXgetstat (e.env, e.lp);
       if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD)) {
         break;
@@ -97,7 +183,8 @@ int P3Task::solve(Env & e, Problem & p, int * result, double * rhs) {
 
   if ((solnstat != CPXMIP_INFEASIBLE) && (solnstat != CPXMIP_INForUNBD)) {
     // Get the solution vector
-    double * soln = new double[cur_numcols];
+    soln_.resize(cur_numcols);
+    double * soln = soln_.data();
     CPXgetx(e.env, e.lp, soln, 0, cur_numcols - 1);
     // Now run through the rest of the objectives.
     for (int j = 0; j < p.objcnt; j++) {
@@ -109,17 +196,323 @@ int P3Task::solve(Env & e, Problem & p, int * result, double * rhs) {
       }
       result[j] = round(res);
     }
-    delete[] soln;
   }
 
-  delete[] srhs;
+  return solnstat;
+}
+
+/* Optimise the current problem, counting the IP and its nodes. */
+int P3Task::mipopt(Env & e) {
+  int status = CPXXmipopt(e.env, e.lp);
+  ipcount++;
+  walkips++;
+  ipnodes += CPXXgetnodecnt(e.env, e.lp);
+  return status;
+}
+
+/* Make the LP relaxation that lpInfeasible() solves. It has no objective,
+ * so it can only be infeasible or optimal, and keeps its basis from one
+ * screen to the next. */
+void P3Task::setupScreen(Env & e, Problem & p) {
+  int status;
+  screen_ = CPXXcloneprob(e.env, e.lp, &status);
+  if (status == 0)
+    status = CPXXchgprobtype(e.env, screen_, CPXPROB_LP);
+  if (status == 0) {
+    int cur_numcols = CPXXgetnumcols(e.env, screen_);
+    std::vector<double> zero(cur_numcols, 0);
+    status = CPXXchgobj(e.env, screen_, cur_numcols, p.objind[0],
+        zero.data());
+  }
+  if (status == 0)
+    status = CPXXgetlongparam(e.env, CPXPARAM_Simplex_Limits_Iterations,
+        &itLimit_);
+  if (status) {
+    std::cerr << "Warning: could not set up the LP screen." << std::endl;
+    if (screen_ != NULL)
+      CPXXfreeprob(e.env, &screen_);
+    screen_ = NULL;
+  }
+}
+
+/* Does rhs ask some objective to be better than its ideal value? If so, the
+ * IP is infeasible. */
+bool P3Task::pastIdeal(Problem & p, const double * rhs) {
+  const std::vector<double> & ideal = opts_->ideal;
+  if (ideal.empty())
+    return false;
+  for (int j = 0; j < p.objcnt; ++j) {
+    if ((p.objsen == MIN) ? (rhs[j] < ideal[j]) : (rhs[j] > ideal[j])) {
+      idealskipped++;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Is the LP relaxation under rhs infeasible? If so, so is the IP. Only a
+ * limited number of dual simplex iterations are spent finding out, and if
+ * they run out we say no. */
+bool P3Task::lpInfeasible(Env & e, Problem & p, const double * rhs) {
+  int status = CPXXchgrhs(e.env, screen_, p.objcnt, p.conind, rhs);
+  if (status)
+    return false;
+  // The limit is shared with the IPs, so it is only set while we screen.
+  CPXXsetlongparam(e.env, CPXPARAM_Simplex_Limits_Iterations,
+      opts_->lpScreen);
+  status = CPXXdualopt(e.env, screen_);
+  CPXXsetlongparam(e.env, CPXPARAM_Simplex_Limits_Iterations, itLimit_);
+  lpscreens++;
+  if (status)
+    return false;
+  // With no objective, the LP cannot be unbounded.
+  int solnstat = CPXXgetstat(e.env, screen_);
+  if ((solnstat != CPX_STAT_INFEASIBLE) && (solnstat != CPX_STAT_INForUNBD))
+    return false;
+  lpscreened++;
+  return true;
+}
 
+/* Store each supported point z in our box as the result under the bounds
+ * z itself sets on the walked objectives. Anything under those bounds that
+ * beat z on objectives_[0] would dominate it, so z is the lexicographic
+ * optimum there, and any walk step that z satisfies is answered at once. */
+void P3Task::seed(Solutions & s, const double * rhs) {
+  std::vector<double> lp(rhs, rhs + objCountTotal_);
+  const std::vector<int> & points = opts_->supported;
+  for (size_t n = 0; n + objCountTotal_ <= points.size();
+      n += objCountTotal_) {
+    const int * z = points.data() + n;
+    bool inside = true;
+    for (int i = 1; i < objCount_; ++i) {
+      int o = objectives_[i];
+      inside = inside && (z[o] >= bounds_[0][i]) && (z[o] <= bounds_[1][i]);
+      lp[o] = z[o];
+    }
+    if (inside)
+      s.insert(lp.data(), z, false);
+  }
+}
+
+/* Tell CPLEX that the optimum of the weighted sum of the given objectives
+ * under rhs is no worse than the best stored result that satisfies rhs, so
+ * that it can prune any node that is worse. The cutoff sits half way to the
+ * next worse value, so the optimum itself is never cut off; if values are not
+ * integers, no cutoff is set. */
+void P3Task::cutoff(Env & e, Problem & p, const double * rhs,
+    const int * objectives, const double * weights, int count) {
+  bool integral = true;
+  for (int i = 0; i < count; ++i) {
+    integral = integral && p.objintegral[objectives[i]] &&
+      (weights[i] == std::round(weights[i]));
+  }
+  double value;
+  bool known = integral && (known_ != nullptr) &&
+    known_->bound(rhs, objectives, weights, count, value);
+  if (p.objsen == MIN) {
+    CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_UpperCutoff,
+        known ? value + 0.5 : 1e75);
+  } else {
+    CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_LowerCutoff,
+        known ? value - 0.5 : -1e75);
+  }
+  if (known)
+    cutoffs++;
+}
+
+/* Give CPLEX x, which satisfies the rhs of the coming solve, as a start. */
+void P3Task::addStart(Env & e, Problem & p, const double * x) {
+  int cur_numcols = CPXXgetnumcols(e.env, e.lp);
+  CPXNNZ beg[1] = { 0 };
+  int effort[1] = { CPX_MIPSTART_CHECKFEAS };
+  int status = CPXXaddmipstarts(e.env, e.lp, 1, cur_numcols, beg,
+      p.objind[0], x, effort, NULL);
+  if (status == 0)
+    mipstarts++;
+}
+
+/* Keep what the solution pool found as witnesses, then empty the pool and
+ * drop any start, ready for the next solve. */
+void P3Task::harvest(Env & e, Problem & p) {
+  int cur_numcols = CPXXgetnumcols(e.env, e.lp);
+  int n = CPXXgetsolnpoolnumsolns(e.env, e.lp);
+  int limit = std::min(n, opts_->harvestPool);
+  soln_.resize(cur_numcols);
+  poolValues_.resize(p.objcnt);
+  double * soln = soln_.data();
+  for (int s = 0; s < limit; ++s) {
+    if (CPXXgetsolnpoolx(e.env, e.lp, s, soln, 0, cur_numcols - 1) != 0)
+      continue;
+    for (int j = 0; j < p.objcnt; j++) {
+      double res = 0;
+      for(int i = 0; i < cur_numcols; ++i) {
+        res += p.objcoef[j][i] * soln[i];
+      }
+      poolValues_[j] = round(res);
+    }
+    if (witnesses_.insert(poolValues_.data(), soln, cur_numcols))
+      poolharvested++;
+  }
+  if (n > 0)
+    CPXXdelsolnpoolsolns(e.env, e.lp, 0, n - 1);
+  int starts = CPXXgetnummipstarts(e.env, e.lp);
+  if (starts > 0)
+    CPXXdelmipstarts(e.env, e.lp, 0, starts - 1);
+}
+
+/* Replace the objective by the weighted sum of ours, for solveAugmented().
+ * Every weighted value is an integer, so a gap below 1 is exact. Returns
+ * false (and changes nothing) if no safe weights exist. */
+bool P3Task::setupAugmented(Env & e, Problem & p) {
+  std::vector<double> weights(objCount_);
+  if (! p.lexicographic_weights(objectives_, objCount_, weights.data()))
+    return false;
+  int cur_numcols = CPXXgetnumcols(e.env, e.lp);
+  std::vector<double> coef(cur_numcols, 0);
+  for (int i = 0; i < objCount_; ++i) {
+    int j = objectives_[i];
+    for (int c = 0; c < cur_numcols; ++c) {
+      coef[c] += weights[i] * p.objcoef[j][c];
+    }
+  }
+  int status = CPXXchgobj(e.env, e.lp, cur_numcols, p.objind[0], coef.data());
+  if (status) {
+    std::cerr << "Failed to set objective." << std::endl;
+    return false;
+  }
+  CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_MIPGap, 0);
+  CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_AbsMIPGap, 0.5);
+  CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_Integrality, 0);
+  weights_ = weights;
+  return true;
+}
+
+/* One MIP over the weighted sum set up by setupAugmented(). */
+int P3Task::solveAugmented(Env & e, Problem & p, int * result,
+    double * rhs) {
+  int cur_numcols = CPXXgetnumcols(e.env, e.lp);
+  int status = CPXXchgrhs(e.env, e.lp, p.objcnt, p.conind, rhs);
+  if (status) {
+    std::cerr << "Failed to change constraint srhs" << std::endl;
+  }
+  if (opts_->cutoff)
+    cutoff(e, p, rhs, objectives_, weights_.data(), objCount_);
+  status = mipopt(e);
+  if (status) {
+    std::cerr << "Failed to optimize LP." << std::endl;
+  }
+  int solnstat = CPXgetstat(e.env, e.lp);
+  if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD))
+    return solnstat;
+  soln_.resize(cur_numcols);
+  double * soln = soln_.data();
+  CPXXgetx(e.env, e.lp, soln, 0, cur_numcols - 1);
+  for (int j = 0; j < p.objcnt; j++) {
+    double res = 0;
+    for(int i = 0; i < cur_numcols; ++i) {
+      res += p.objcoef[j][i] * soln[i];
+    }
+    result[j] = round(res);
+  }
   return solnstat;
 }
 
+#if CPX_VERSION >= 12090000
+/* Replace the objective by ours, in priority order, for solveNative(). Each
+ * has no tolerance, so that the result matches solveSequential(). */
+void P3Task::setupNative(Env & e, Problem & p) {
+  int cur_numcols = CPXXgetnumcols(e.env, e.lp);
+  int status = CPXXsetnumobjs(e.env, e.lp, objCount_);
+  for (int i = 0; (status == 0) && (i < objCount_); ++i) {
+    int j = objectives_[i];
+    status = CPXXmultiobjsetobj(e.env, e.lp, i, cur_numcols, p.objind[j],
+        p.objcoef[j], 0 /* offset */, 1 /* weight */,
+        objCount_ - i /* priority */, 0 /* abstol */, 0 /* reltol */, NULL);
+  }
+  if (status) {
+    std::cerr << "Failed to set objectives." << std::endl;
+  }
+}
+
+/* One call to the lexicographic solver of CPLEX, which reuses its search
+ * between objectives. */
+int P3Task::solveNative(Env & e, Problem & p, int * result, double * rhs) {
+  int cur_numcols = CPXXgetnumcols(e.env, e.lp);
+  int status = CPXXchgrhs(e.env, e.lp, p.objcnt, p.conind, rhs);
+  if (status) {
+    std::cerr << "Failed to change constraint srhs" << std::endl;
+  }
+  soln_.resize(cur_numcols);
+  double * soln = soln_.data();
+  bool retry = true;
+  while (retry) {
+    status = CPXXmultiobjopt(e.env, e.lp, NULL);
+    ipcount++;
+    if (status) {
+      std::cerr << "Failed to optimize multi-objective problem." << std::endl;
+      exit(0);
+    }
+    int solnstat = CPXgetstat(e.env, e.lp);
+    if (solnstat == CPX_STAT_MULTIOBJ_INFEASIBLE)
+      return CPXMIP_INFEASIBLE;
+    if ((solnstat == CPX_STAT_MULTIOBJ_INForUNBD) ||
+        (solnstat == CPX_STAT_MULTIOBJ_UNBOUNDED))
+      return CPXMIP_INForUNBD;
+    // Anything else (a limit, or an objective that could not be solved to
+    // optimality) leaves no lexicographic optimum to read.
+    if (solnstat != CPX_STAT_MULTIOBJ_OPTIMAL) {
+      std::cerr << "Failed to obtain multi-objective optimum (status ";
+      std::cerr << solnstat << ")." << std::endl;
+      exit(0);
+    }
+    CPXXgetx(e.env, e.lp, soln, 0, cur_numcols - 1);
+    for (int j = 0; j < p.objcnt; j++) {
+      double res = 0;
+      for(int i = 0; i < cur_numcols; ++i) {
+        res += p.objcoef[j][i] * soln[i];
+      }
+      result[j] = round(res);
+    }
+    // As in solveSequential(), large objective values need a smaller gap.
+    retry = false;
+    for (int i = 0; i < objCount_; ++i) {
+      while (std::abs(result[objectives_[i]]) > 1/p.mip_tolerance) {
+        p.mip_tolerance /= 10;
+        retry = true;
+      }
+    }
+    if (retry) {
+      CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_MIPGap, p.mip_tolerance);
+    }
+  }
+  return CPXMIP_OPTIMAL;
+}
+#endif
+
+/* Record a feasible result as one of our solutions. This happens as results
+ * are stored, rather than at the end, as the store may evict them. Walks
+ * reach the same point under many right-hand sides, so each point is only
+ * recorded once. */
+void P3Task::keep(const Result * r) {
+  if (r->infeasible || (kept_.count(r->result) > 0))
+    return;
+  int * n = newSolution();
+  for (int i = 0; i < objCountTotal_; ++i) {
+    n[i] = r->result[i];
+  }
+  kept_.insert(n);
+}
+
 
 Status P3Task::operator()() {
   status_ = RUNNING;
+  // Once interrupted, no new walks are started.
+  if (interrupted) {
+    stoppedEarly++;
+    all_.reset();
+    done();
+    return status_;
+  }
 #ifdef DEBUG
   std::cout << details();
 #endif
@@ -148,6 +541,8 @@ Status P3Task::operator()() {
   }
 
   Problem p(filename_.c_str(), e);
+  if (! opts_->ideal.empty())
+    p.restrict(e, opts_->ideal.data(), opts_->worst.data());
 
 #ifdef FINETIMING
   double cplex_time = 0;
@@ -157,9 +552,17 @@ Status P3Task::operator()() {
   double total_time = start.tv_sec + start.tv_nsec/1e9;
 #endif
 
-  Solutions s(p.objcnt);
+  Solutions s(p.objcnt, p.objsen, opts_->cacheBytes);
+  known_ = &s;
+  RelaxationFile * file = opts_->relaxFile;
+  uint64_t fileKey = 0;
+  if (file) {
+    fileKey = file->key(objectives_, objCount_);
+    s.attach(file, fileKey);
+  }
   int infcnt;
   bool inflast;
+  bool stopped = false;
   bool infeasible;
   int * max, * min,  * result, *resultStore;
   double * rhs;
@@ -182,6 +585,25 @@ Status P3Task::operator()() {
     }
   }
 
+  // Clone the screen while e.lp still has a single objective: after
+  // setupNative() it would carry all of ours.
+  if (opts_->lpScreen > 0)
+    setupScreen(e, p);
+
+  if (opts_->solveMode == AUGMENTED)
+    augmented_ = setupAugmented(e, p);
+#if CPX_VERSION >= 12090000
+  if (opts_->solveMode == NATIVE)
+    setupNative(e, p);
+#endif
+
+  // Every lookup from here on only changes the rhs of objectives_[1..], and
+  // stays (mostly) within our box.
+  s.index(rhs, objectives_ + 1, bounds_[0] + 1, bounds_[1] + 1, objCount_ - 1,
+      opts_->gridCells);
+  if (objCount_ == objCountTotal_)
+    seed(s, rhs);
+
 #ifdef FINETIMING
   clock_gettime(CLOCK_MONOTONIC, &start);
   double starttime = (start.tv_sec + start.tv_nsec/1e9);
@@ -215,8 +637,11 @@ Status P3Task::operator()() {
   debug_mutex.unlock();
 #endif
   Sense sense = p.objsen;
+  auto pastBoundary = selectKernel<PastBoundary>(objCount_ - 1, sense);
   /* Need to add a result to the list here*/
-  s.insert(rhs, result, solnstat == CPXMIP_INFEASIBLE);
+  keep(s.insert(rhs, result, solnstat == CPXMIP_INFEASIBLE));
+  if (file)
+    file->append(fileKey, rhs, result, solnstat == CPXMIP_INFEASIBLE, sense_);
   // Note that if we are splitting, we aren't sharing.
   min = new int[objCountTotal_];
   max = new int[objCountTotal_];
@@ -236,13 +661,9 @@ Status P3Task::operator()() {
     inflast = false; /* Last iteration infeasible?*/
 
 
-    /* Set all constraints back to infinity*/
+    /* Set all constraints back to their loosest*/
     for (int j = 1; j < objCount_; ++j) {
-      if (sense == MIN) {
-        rhs[j] = CPX_INFBOUND;
-      } else {
-        rhs[j] = -CPX_INFBOUND;
-      }
+      rhs[j] = p.rhs[j];
     }
     if (sense == MIN) {
       for (int i = 1; i < objCount_; ++i) {
@@ -257,15 +678,20 @@ Status P3Task::operator()() {
     }
     /* Set rhs of current depth */
     if (sense == MIN) {
-      rhs[objective] = max[objective]-1;
+      rhs[objective] = max[objective]-step(objective, max[objective]);
     } else {
-      rhs[objective] = min[objective]+1;
+      rhs[objective] = min[objective]+step(objective, min[objective]);
     }
 
     max[objective] = (int) -CPX_INFBOUND;
     min[objective] = (int) CPX_INFBOUND;
 
     while (infcnt < objective_counter) {
+      // Stop between solves if interrupted, keeping what we have found.
+      if (interrupted) {
+        stopped = true;
+        break;
+      }
       bool relaxed;
       int solnstat;
       /* Look for possible relaxations to the current problem*/
@@ -277,36 +703,33 @@ Status P3Task::operator()() {
       debug_mutex.unlock();
 #endif
       // First check if it's infeasible
-      relaxation = s.find(rhs, p.objsen);
+      relaxation = s.find(rhs, p.objsen, all_.get());
       relaxed = (relaxation != nullptr);
       if (relaxed) {
         infeasible = relaxation->infeasible;
         result = relaxation->result;
+        // It may have come from the shared store or the cache file, rather
+        // than from one of our own solves.
+        keep(relaxation);
       } else {
-        if (all_)
-          relaxation = all_->find(rhs, p.objsen);
-        if (relaxation != nullptr) {
-          result = relaxation->result;
-          infeasible = relaxation->infeasible;
-          s.insert(relaxation);
-        } else {
-          /* Solve in the absence of a relaxation*/
-          result = resultStore;
+        /* Solve in the absence of a relaxation*/
+        result = resultStore;
 #ifdef FINETIMING
-          clock_gettime(CLOCK_MONOTONIC, &start);
-          double starttime = (start.tv_sec + start.tv_nsec/1e9);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        double starttime = (start.tv_sec + start.tv_nsec/1e9);
 #endif
-          solnstat = solve(e, p, result, rhs);
+        solnstat = solve(e, p, result, rhs);
 #ifdef FINETIMING
-          clock_gettime(CLOCK_MONOTONIC, &start);
-          cplex_time += (start.tv_sec + start.tv_nsec/1e9) - starttime;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        cplex_time += (start.tv_sec + start.tv_nsec/1e9) - starttime;
 #endif
-          infeasible = ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD));
-          /* Store result */
-          s.insert(rhs, result, infeasible);
-          if (all_)
-            all_->insert(rhs, result, infeasible);
-        }
+        infeasible = ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD));
+        /* Store result */
+        keep(s.insert(rhs, result, infeasible));
+        if (file)
+          file->append(fileKey, rhs, result, infeasible, sense_);
+        if (all_)
+          all_->insert(rhs, result, infeasible);
       }
 #ifdef DEBUG
       debug_mutex.lock();
@@ -334,46 +757,9 @@ Status P3Task::operator()() {
       debug_mutex.unlock();
 #endif
       // See if we've gone past our boundary
-      if (!infeasible) {
-        if (sense == MIN) {
-          for (int i = 1; i < objCount_; ++i) {
-            double stop = bounds_[0][i];
-            if (rhs[objectives_[i]] <= stop) {
-              infeasible = true;
-              break;
-            }
-          }
-        } else {
-          for (int i = 1; i < objCount_; ++i) {
-            double stop = bounds_[1][i];
-            if (rhs[objectives_[i]] >= stop) {
-              infeasible = true;
-              break;
-            }
-          }
-        }
-        // Alternatively, check if all results are past the boundary
-        bool allPast = true;
-        if (sense == MIN) {
-          for (int i = 1; i < objCount_; ++i) {
-            double stop = bounds_[0][i];
-            if (result[objectives_[i]] > stop) {
-              allPast = false;
-              break;
-            }
-          }
-        } else {
-          for (int i = 1; i < objCount_; ++i) {
-            double stop = bounds_[1][i];
-            if (rhs[objectives_[i]] < stop) {
-              allPast = false;
-              break;
-            }
-          }
-        }
-        if (allPast) {
-          infeasible = true;
-        }
+      if ((!infeasible) && pastBoundary(rhs, result, objectives_ + 1,
+            bounds_[0] + 1, bounds_[1] + 1, objCount_ - 1)) {
+        infeasible = true;
       }
       if (infeasible) {
         infcnt++;
@@ -396,13 +782,9 @@ Status P3Task::operator()() {
       }
 
       if (infeasible && (infcnt == objective_counter-1)) {
-        /* Set all constraints back to infinity */
+        /* Set all constraints back to their loosest */
         for (int j = 0; j < objCountTotal_; j++) {
-          if (sense == MIN) {
-            rhs[j] = CPX_INFBOUND;
-          } else {
-            rhs[j] = -CPX_INFBOUND;
-          }
+          rhs[j] = p.rhs[j];
         }
         // Reset to start point, not to infinity, if we know the start point!
         for(int i = 1; i < objCount_; ++i) {
@@ -423,10 +805,10 @@ Status P3Task::operator()() {
                 start = bounds_[1][i];
               }
             }
-            if (start < max[objective]-1) {
+            if (start < max[objective]-step(objective, max[objective])) {
               rhs[objective] = start;
             } else {
-              rhs[objective] = max[objective]-1;
+              rhs[objective] = max[objective]-step(objective, max[objective]);
             }
             max[objective] = (int) -CPX_INFBOUND;
           }
@@ -438,10 +820,10 @@ Status P3Task::operator()() {
                 start = bounds_[0][i];
               }
             }
-            if (start > min[objective]+1) {
+            if (start > min[objective]+step(objective, min[objective])) {
               rhs[objective] = start;
             } else {
-              rhs[objective] = min[objective]+1;
+              rhs[objective] = min[objective]+step(objective, min[objective]);
             }
             min[objective] = (int) CPX_INFBOUND;
           }
@@ -452,11 +834,7 @@ Status P3Task::operator()() {
         depth = objectives_[depth_level];
         onwalk = false;
       } else if (inflast && infcnt != objective_counter) {
-        if (sense == MIN) {
-          rhs[depth] = CPX_INFBOUND;
-        } else {
-          rhs[depth] = -CPX_INFBOUND;
-        }
+        rhs[depth] = p.rhs[depth];
         // Reset to start point, not to infinity, if we know the start point!
         for(int i = 1; i < objCount_; ++i) {
           if (objectives_[i] == depth) {
@@ -470,35 +848,42 @@ Status P3Task::operator()() {
         depth_level++;
         depth = objectives_[depth_level];
         if (sense == MIN) {
-          rhs[depth] = max[depth]-1;
+          rhs[depth] = max[depth]-step(depth, max[depth]);
           max[depth] = (int) -CPX_INFBOUND;
         } else {
-          rhs[depth] = min[depth]+1;
+          rhs[depth] = min[depth]+step(depth, min[depth]);
           min[depth] = (int) CPX_INFBOUND;
         }
         onwalk = true;
       } else if (!onwalk && infcnt != 1) {
         if (sense == MIN) {
-          rhs[depth] = max[depth]-1;
+          rhs[depth] = max[depth]-step(depth, max[depth]);
           max[depth] = (int) -CPX_INFBOUND;
         } else {
-          rhs[depth] = min[depth]+1;
+          rhs[depth] = min[depth]+step(depth, min[depth]);
           min[depth] = (int) CPX_INFBOUND;
         }
       } else if (onwalk && infcnt != 1)  {
         depth_level = 1;
         depth = objectives_[depth_level];
         if (sense == MIN) {
-          rhs[depth] = max[depth]-1;
+          rhs[depth] = max[depth]-step(depth, max[depth]);
           max[depth] = (int) -CPX_INFBOUND;
         } else {
-          rhs[depth] = min[depth]+1;
+          rhs[depth] = min[depth]+step(depth, min[depth]);
           min[depth] = (int) CPX_INFBOUND;
         }
         onwalk = false;
       }
     }
+    if (stopped)
+      break;
   }
+  if (stopped)
+    stoppedEarly++;
+  known_ = nullptr;
+  if (screen_ != NULL)
+    CPXXfreeprob(e.env, &screen_);
   CPXfreeprob(e.env, &e.lp);
   CPXcloseCPLEX(&e.env);
 #ifdef FINETIMING
@@ -512,17 +897,11 @@ Status P3Task::operator()() {
   delete[] rhs;
   delete[] min;
   delete[] max;
+  // Release our hold on the shared store, so that the last P3Task to finish
+  // frees it.
+  all_.reset();
 
-  for(Result * r: s) {
-    if (r->infeasible)
-      continue;
-    int * n = new int[p.objcnt];
-    for (int i = 0; i < p.objcnt; ++i) {
-      n[i] = r->result[i];
-    }
-    solutions_.push_back(n);
-  }
-  status_ = DONE;
+  done();
   return status_;
 }
 
@@ -18,32 +18,106 @@ You should have received a copy of the GNU General Public License along with thi
 #include <mutex>
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
 #include "box.h"
 #include "task.h"
 #include "env.h"
 #include "problem.h"
+#include "options.h"
 #include "solutions.h"
+#include "witnesses.h"
+
+/* Hashes and compares points by value, over n objectives. */
+struct PointHash {
+  int n;
+  size_t operator()(const int * p) const {
+    size_t h = 0;
+    for (int i = 0; i < n; ++i) {
+      h = h * 31 + static_cast<size_t>(p[i]);
+    }
+    return h;
+  }
+};
+
+struct PointEqual {
+  int n;
+  bool operator()(const int * a, const int * b) const {
+    return std::equal(a, a + n, b);
+  }
+};
 
 class P3Task : public Task {
   public:
     P3Task(Box * b, std::string & filename, int objCount, int objCountTotal,
-        int * objectives, Sense sense, Solutions * all = nullptr);
+        int * objectives, Sense sense, const Options * opts,
+        std::shared_ptr<Solutions> all = nullptr);
     ~P3Task();
     Status operator()();
 
 
     virtual std::string str() const;
     virtual std::string details() const;
+    virtual bool certified() const;
   private:
     int solve(Env & e, Problem & p, int * result, double * rhs);
+    int solveSequential(Env & e, Problem & p, int * result, double * rhs);
+    int mipopt(Env & e);
+    void setupScreen(Env & e, Problem & p);
+    bool pastIdeal(Problem & p, const double * rhs);
+    bool lpInfeasible(Env & e, Problem & p, const double * rhs);
+    void seed(Solutions & s, const double * rhs);
+    void cutoff(Env & e, Problem & p, const double * rhs,
+        const int * objectives, const double * weights, int count);
+    void addStart(Env & e, Problem & p, const double * x);
+    void harvest(Env & e, Problem & p);
+    bool setupAugmented(Env & e, Problem & p);
+    int solveAugmented(Env & e, Problem & p, int * result, double * rhs);
+#if CPX_VERSION >= 12090000
+    void setupNative(Env & e, Problem & p);
+    int solveNative(Env & e, Problem & p, int * result, double * rhs);
+#endif
+    void keep(const Result * r);
+    int step(int o, int v) const;
     double **bounds_;
+    // Are we walking with a tolerance?
+    bool coarse_;
+    // Did setupAugmented() succeed?
+    bool augmented_;
+    // Scratch space for solve().
+    std::vector<double> srhs_;
+    std::vector<char> objectivesDone_;
+    std::vector<double> soln_;
+    std::vector<int> poolValues_;
+    // Weights of the objective set up by setupAugmented().
+    std::vector<double> weights_;
+    Witnesses witnesses_;
+    // Every point recorded by keep(), pointing at our own copies.
+    std::unordered_set<const int *, PointHash, PointEqual> kept_;
+    // Our relaxation store, whose results give the cutoffs of each solve.
+    Solutions * known_;
+    // The LP relaxation used by lpInfeasible(), or NULL if not screening.
+    CPXLPptr screen_;
+    CPXCNT itLimit_;
 
-    Solutions * all_;
+    const Options * opts_;
+    std::shared_ptr<Solutions> all_;
 };
 
 inline P3Task::P3Task(Box * b, std::string & filename, int objCount,
-    int objCountTotal, int * objectives, Sense sense, Solutions * all) :
-    Task(filename, objCount, objCountTotal, objectives, sense), all_(all) {
+    int objCountTotal, int * objectives, Sense sense, const Options * opts,
+    std::shared_ptr<Solutions> all) :
+    Task(filename, objCount, objCountTotal, objectives, sense),
+    coarse_((! opts->epsilon.empty()) && (objCount == objCountTotal)),
+    augmented_(false), witnesses_(objCountTotal, sense),
+    kept_(16, PointHash{objCountTotal}, PointEqual{objCountTotal}),
+    known_(nullptr),
+    screen_(NULL), itLimit_(0), opts_(opts),
+    all_(all) {
   bounds_ = new double*[2];
   bounds_[0] = new double[objCount_];
   bounds_[1] = new double[objCount_];
@@ -58,5 +132,30 @@ inline P3Task::~P3Task() {
   delete[] bounds_[1];
   delete[] bounds_;
 }
+/* How far to move the rhs of objective o past v, the worst value reached on
+ * it. Without a tolerance, this is the next value that o can take. A
+ * relative tolerance is a fraction of v, and main only allows one on
+ * objectives that cannot be negative. */
+inline int P3Task::step(int o, int v) const {
+  int g = opts_->lattice.empty() ? 1 : opts_->lattice[o];
+  if (! coarse_)
+    return g;
+  double tolerance = opts_->epsilon[o];
+  if (opts_->epsilonRelative[o]) {
+    // v may be one of the sentinels for "nothing found yet", so keep the
+    // step from overflowing.
+    tolerance = std::min(tolerance / 100 * std::abs(static_cast<double>(v)),
+        1e9);
+  }
+  return (static_cast<int>(tolerance) / g + 1) * g;
+}
+
+/* Each solution is lexicographically optimal over our objectives, subject to
+ * upper bounds on every objective. Once we have every objective, nothing can
+ * dominate it. */
+inline bool P3Task::certified() const {
+  return objCount_ == objCountTotal_;
+}
+
 #endif /* P3TASK_H */
 
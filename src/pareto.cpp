@@ -0,0 +1,182 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <numeric>
+
+#include "kernels.h"
+#include "pareto.h"
+
+// Subproblems smaller than this are never split across threads.
+static const size_t PARALLEL_CUTOFF = 4096;
+
+static bool sameRow(const int * a, const int * b, int k) {
+  return std::equal(a, a + k, b);
+}
+
+/* Two objectives, points sorted: a point is dominated exactly when some
+ * earlier, different, point has a second value no larger than its own. */
+static void sweep2(const int * points, size_t n, std::vector<char> & dominated) {
+  bool any = false;
+  int best = 0;
+  size_t i = 0;
+  while (i < n) {
+    size_t j = i + 1;
+    while ((j < n) && sameRow(points + 2 * i, points + 2 * j, 2)) {
+      ++j;
+    }
+    int y = points[2 * i + 1];
+    if (any && (best <= y)) {
+      std::fill(dominated.begin() + i, dominated.begin() + j, 1);
+    } else {
+      best = y;
+      any = true;
+    }
+    i = j;
+  }
+}
+
+/* Three objectives, points sorted: as for two, but the earlier points are
+ * summarised by the staircase of their last two values, kept in a map from
+ * second value to third value (the third value strictly decreasing). */
+static void sweep3(const int * points, size_t n, std::vector<char> & dominated) {
+  std::map<int, int> stair;
+  size_t i = 0;
+  while (i < n) {
+    size_t j = i + 1;
+    while ((j < n) && sameRow(points + 3 * i, points + 3 * j, 3)) {
+      ++j;
+    }
+    int y = points[3 * i + 1];
+    int z = points[3 * i + 2];
+    auto it = stair.upper_bound(y);
+    if ((it != stair.begin()) && (std::prev(it)->second <= z)) {
+      std::fill(dominated.begin() + i, dominated.begin() + j, 1);
+    } else {
+      it = stair.lower_bound(y);
+      while ((it != stair.end()) && (it->second >= z)) {
+        it = stair.erase(it);
+      }
+      stair.emplace_hint(it, y, z);
+    }
+    i = j;
+  }
+}
+
+/* Kung et al.: the front of the sorted rows [first, last) is the front of
+ * the first half, plus each point in the front of the second half that no
+ * point in the first front dominates. front gets the row numbers. */
+template <int K>
+struct Kung {
+  static void run(const int * points, int k, size_t first, size_t last,
+      int threads, std::vector<size_t> & front) {
+    if (last - first == 1) {
+      front.push_back(first);
+      return;
+    }
+    size_t mid = first + (last - first) / 2;
+    std::vector<size_t> bottom;
+    if ((threads > 1) && (last - first >= PARALLEL_CUTOFF)) {
+      int half = threads / 2;
+      auto top = std::async(std::launch::async, [=, &front]() {
+          run(points, k, first, mid, half, front);
+        });
+      run(points, k, mid, last, threads - half, bottom);
+      top.get();
+    } else {
+      run(points, k, first, mid, 1, front);
+      run(points, k, mid, last, 1, bottom);
+    }
+    std::vector<char> keep(bottom.size(), 1);
+    auto check = [&](size_t from, size_t to) {
+      for (size_t b = from; b < to; ++b) {
+        const int * p = points + bottom[b] * k;
+        for (size_t t: front) {
+          if (dominates<K, MIN>(points + t * k, p, k)) {
+            keep[b] = 0;
+            break;
+          }
+        }
+      }
+    };
+    if ((threads > 1) && (front.size() * bottom.size() >= PARALLEL_CUTOFF)) {
+      std::vector<std::future<void>> parts;
+      size_t chunk = (bottom.size() + threads - 1) / threads;
+      for (size_t from = chunk; from < bottom.size(); from += chunk) {
+        parts.push_back(std::async(std::launch::async, check, from,
+              std::min(from + chunk, bottom.size())));
+      }
+      check(0, std::min(chunk, bottom.size()));
+      for (auto & part: parts) {
+        part.get();
+      }
+    } else {
+      check(0, bottom.size());
+    }
+    for (size_t b = 0; b < bottom.size(); ++b) {
+      if (keep[b])
+        front.push_back(bottom[b]);
+    }
+  }
+};
+
+std::vector<char> findDominated(const std::vector<const int *> & solutions,
+    int k, Sense sense, int threads) {
+  size_t n = solutions.size();
+  std::vector<char> dominated(n, 0);
+  if ((n < 2) || (k < 1))
+    return dominated;
+  std::vector<size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  // Sort so that any dominating point comes before the points it dominates.
+  auto better = [&](size_t a, size_t b) {
+    const int * x = solutions[a];
+    const int * y = solutions[b];
+    for (int i = 0; i < k; ++i) {
+      if (x[i] != y[i])
+        return (sense == MIN) ? (x[i] < y[i]) : (x[i] > y[i]);
+    }
+    return false;
+  };
+  std::sort(order.begin(), order.end(), better);
+  std::vector<int> points(n * k);
+  for (size_t r = 0; r < n; ++r) {
+    const int * s = solutions[order[r]];
+    for (int i = 0; i < k; ++i) {
+      points[r * k + i] = (sense == MIN) ? s[i] : -s[i];
+    }
+  }
+  std::vector<char> sortedDominated(n, 0);
+  if (k == 1) {
+    for (size_t r = 1; r < n; ++r) {
+      sortedDominated[r] = (points[r] != points[0]);
+    }
+  } else if (k == 2) {
+    sweep2(points.data(), n, sortedDominated);
+  } else if (k == 3) {
+    sweep3(points.data(), n, sortedDominated);
+  } else {
+    std::vector<size_t> front;
+    selectKernel<Kung>(k)(points.data(), k, 0, n, threads, front);
+    std::fill(sortedDominated.begin(), sortedDominated.end(), 1);
+    for (size_t r: front) {
+      sortedDominated[r] = 0;
+    }
+  }
+  for (size_t r = 0; r < n; ++r) {
+    dominated[order[r]] = sortedDominated[r];
+  }
+  return dominated;
+}
@@ -0,0 +1,40 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef PARETO_H
+#define PARETO_H
+
+#include <vector>
+
+#include "sense.h"
+
+/**
+ * Nondominated filtering of a set of solutions.
+ *
+ * Only the first k values of each solution are compared. The solutions are
+ * copied into one contiguous array, sorted lexicographically (after negating
+ * every value of a maximisation problem), and then filtered with
+ *  - a sweep line for k = 2,
+ *  - a sweep over a balanced tree holding the 2D staircase for k = 3, and
+ *  - Kung's divide and conquer for k > 3, run on up to threads threads.
+ * All of these take O(n log n) for k <= 3.
+ *
+ * A solution is dominated if another is at least as good in all k values
+ * and strictly better in one, so identical solutions are either all kept or
+ * all dropped. Returns one flag per solution, in the given order, which is
+ * set if that solution is dominated.
+ */
+std::vector<char> findDominated(const std::vector<const int *> & solutions,
+    int k, Sense sense, int threads = 1);
+
+#endif /* PARETO_H */
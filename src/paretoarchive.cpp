@@ -0,0 +1,147 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <algorithm>
+#include <iterator>
+
+#include "kernels.h"
+#include "paretoarchive.h"
+#include "radixsort.h"
+
+/* Compare s against every archived solution. If one of them is at least as
+ * good as s, returns false and changes nothing. Otherwise drops every
+ * solution that s dominates, adding it to dropped, and returns true. */
+template <int K>
+struct ArchiveScan {
+  static bool run(std::vector<int> & values,
+      std::vector<const int *> & points, std::vector<const int *> & dropped,
+      const int * s, int k) {
+    const int n = kernelWidth<K>(k);
+    size_t keep = 0;
+    for (size_t row = 0, p = 0; row < values.size(); row += n, ++p) {
+      const int * v = &values[row];
+      // If this row covers s, then s dominates no row (or two rows would
+      // dominate each other), so nothing has been dropped yet.
+      if (weaklyDominates<K, MIN>(v, s, k))
+        return false;
+      if (dominates<K, MIN>(s, v, k)) {
+        dropped.push_back(points[p]);
+      } else {
+        if (keep != row) {
+          std::copy(v, v + n, &values[keep]);
+          points[keep / n] = points[p];
+        }
+        keep += n;
+      }
+    }
+    values.resize(keep);
+    points.resize(keep / n);
+    return true;
+  }
+};
+
+ParetoArchive::ParetoArchive(int k, int width, Sense sense) : k_(k),
+    width_(width), sense_(sense), scratch_(k),
+    scan_(selectKernel<ArchiveScan>(k)), pool_(width * sizeof(int)) {
+}
+
+const int * ParetoArchive::insert(const int * s) {
+  std::unique_lock<std::mutex> lk(mutex_);
+  return insertLocked(s);
+}
+
+void ParetoArchive::insert(const std::vector<const int *> & solutions) {
+  std::unique_lock<std::mutex> lk(mutex_);
+  for (const int * s: solutions) {
+    insertLocked(s);
+  }
+}
+
+const int * ParetoArchive::insertLocked(const int * s) {
+  if (k_ == 2)
+    return insertStair(s);
+  // Everything is kept in minimisation terms, so one scan does for both.
+  for (int i = 0; i < k_; ++i) {
+    scratch_[i] = (sense_ == MIN) ? s[i] : -s[i];
+  }
+  dropped_.clear();
+  if (! scan_(values_, points_, dropped_, scratch_.data(), k_))
+    return nullptr;
+  for (const int * d: dropped_) {
+    pool_.put(const_cast<int *>(d));
+  }
+  values_.insert(values_.end(), scratch_.begin(), scratch_.end());
+  points_.push_back(copy(s));
+  return points_.back();
+}
+
+const int * ParetoArchive::insertStair(const int * s) {
+  int x = (sense_ == MIN) ? s[0] : -s[0];
+  int y = (sense_ == MIN) ? s[1] : -s[1];
+  // The closest step at or left of x is the only one that can cover s.
+  auto it = stair_.upper_bound(x);
+  if ((it != stair_.begin()) && (std::prev(it)->second.first <= y))
+    return nullptr;
+  it = stair_.lower_bound(x);
+  while ((it != stair_.end()) && (it->second.first >= y)) {
+    pool_.put(const_cast<int *>(it->second.second));
+    it = stair_.erase(it);
+  }
+  const int * c = copy(s);
+  stair_.emplace_hint(it, x, std::make_pair(y, c));
+  return c;
+}
+
+const int * ParetoArchive::copy(const int * s) {
+  int * c = static_cast<int *>(pool_.get());
+  std::copy(s, s + width_, c);
+  return c;
+}
+
+std::vector<const int *> ParetoArchive::solutions() const {
+  std::vector<const int *> res;
+  {
+    std::unique_lock<std::mutex> lk(mutex_);
+    if (k_ == 2) {
+      for (auto & step: stair_) {
+        res.push_back(step.second.second);
+      }
+    } else {
+      res = points_;
+    }
+  }
+  if (! radixSortUnique(res, k_)) {
+    const int k = k_;
+    std::stable_sort(res.begin(), res.end(),
+        [k](const int * a, const int * b) {
+          for(int i = 0; i < k; ++i) {
+            if (a[i] < b[i])
+              return false;
+            if (a[i] > b[i])
+              return true;
+          }
+          return false;
+        });
+  }
+  return res;
+}
+
+size_t ParetoArchive::size() const {
+  std::unique_lock<std::mutex> lk(mutex_);
+  return (k_ == 2) ? stair_.size() : points_.size();
+}
+
+Arena ParetoArchive::release() {
+  std::unique_lock<std::mutex> lk(mutex_);
+  return pool_.release();
+}
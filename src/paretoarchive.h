@@ -0,0 +1,92 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef PARETOARCHIVE_H
+#define PARETOARCHIVE_H
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "sense.h"
+
+/**
+ * An online archive of nondominated solutions. Solutions can be inserted
+ * from any thread, at any time, and a solution is rejected straight away if
+ * it is dominated by, or equal to, one already in the archive. Any solutions
+ * that a new one dominates are dropped.
+ *
+ * As with Task::cleanSolutions(), only the first k values of each solution
+ * are compared. The archive keeps its own copy of all width values of each
+ * solution it accepts, so the caller's solutions can be freed as soon as
+ * they have been inserted. The copies of dropped solutions are reused.
+ *
+ * For two objectives the archive is a staircase in a std::map, so each
+ * insertion takes O(log n). Otherwise the compared values are kept in one
+ * contiguous array, which each insertion scans once.
+ */
+class ParetoArchive {
+  public:
+    ParetoArchive(int k, int width, Sense sense);
+
+    /**
+     * Returns our copy of s, or nullptr if s was rejected.
+     */
+    const int * insert(const int * s);
+    void insert(const std::vector<const int *> & solutions);
+
+    /**
+     * The solutions in the archive, in the order used by
+     * Task::sortSolutions().
+     */
+    std::vector<const int *> solutions() const;
+    size_t size() const;
+
+    /**
+     * Hand over the memory holding our copies, so that the pointers from
+     * solutions() can outlive the archive. Nothing may be inserted after.
+     */
+    Arena release();
+
+  private:
+    const int * insertLocked(const int * s);
+    const int * insertStair(const int * s);
+    const int * copy(const int * s);
+
+    int k_;
+    int width_;
+    Sense sense_;
+    mutable std::mutex mutex_;
+
+    // Two objectives: from the first value to the second value and the
+    // solution, all in minimisation terms. The second values strictly
+    // decrease along the map.
+    std::map<int, std::pair<int, const int *>> stair_;
+
+    // Otherwise: k values (in minimisation terms) per archived solution.
+    std::vector<int> values_;
+    std::vector<const int *> points_;
+    std::vector<int> scratch_;
+    // Solutions dropped by the last scan, whose copies can be reused.
+    std::vector<const int *> dropped_;
+    bool (*scan_)(std::vector<int> & values,
+        std::vector<const int *> & points, std::vector<const int *> & dropped,
+        const int * s, int k);
+
+    // Our copies of the archived solutions.
+    Pool pool_;
+};
+
+#endif /* PARETOARCHIVE_H */
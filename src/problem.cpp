@@ -11,6 +11,9 @@ You should have received a copy of the GNU General Public License along with thi
 
 */
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -18,12 +21,14 @@ You should have received a copy of the GNU General Public License along with thi
 #include <sstream>
 #include <vector>
 
+#include "lexweights.h"
 #include "problem.h"
 #include "env.h"
 #include "errors.h"
 
 Problem::Problem(const char * filename, Env& env):
-      objcnt(0), mip_tolerance(1e-4), filename_(filename)
+      objcnt(0), objgcd(nullptr), objintegral(nullptr), objlb(nullptr),
+      objub(nullptr), mip_tolerance(1e-4), filename_(filename)
 {
   filetype = UNKNOWN;
   int len = strlen(filename);
@@ -37,6 +42,128 @@ Problem::Problem(const char * filename, Env& env):
     filetype = MOP;
     read_mop_problem(env);
   }
+  if (objcnt > 0) {
+    find_value_lattices(env);
+    find_value_ranges(env);
+  }
+}
+
+static long gcd(long a, long b) {
+  while (b != 0) {
+    long t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/* For each objective, find the largest g such that every value it takes is
+ * a multiple of g. This is the gcd of its coefficients, if each of them is an
+ * integer on an integer variable, in which case the objective is integral.
+ * Otherwise g is 1. */
+void Problem::find_value_lattices(Env& e) {
+  int cur_numcols = CPXgetnumcols(e.env, e.lp);
+  objgcd = new int[objcnt];
+  objintegral = new bool[objcnt];
+  std::vector<char> ctype(cur_numcols > 0 ? cur_numcols : 1);
+  // Fails if the problem has no integer variables at all.
+  bool typed = (cur_numcols > 0) &&
+    (CPXgetctype(e.env, e.lp, ctype.data(), 0, cur_numcols - 1) == 0);
+  for (int j = 0; j < objcnt; ++j) {
+    long g = 0;
+    objintegral[j] = true;
+    for (int i = 0; i < cur_numcols; ++i) {
+      double c = objcoef[j][i];
+      if (c == 0)
+        continue;
+      if ((! typed) || ((ctype[i] != CPX_INTEGER) && (ctype[i] != CPX_BINARY))
+          || (c != std::round(c)) || (std::abs(c) > INT_MAX)) {
+        g = 1;
+        objintegral[j] = false;
+        break;
+      }
+      g = gcd(g, std::abs(static_cast<long>(c)));
+    }
+    objgcd[j] = (g > 0) ? g : 1;
+  }
+}
+
+/* Bound each objective using the bounds on the variables. */
+void Problem::find_value_ranges(Env& e) {
+  int cur_numcols = CPXgetnumcols(e.env, e.lp);
+  objlb = new double[objcnt];
+  objub = new double[objcnt];
+  std::vector<double> lb(cur_numcols > 0 ? cur_numcols : 1);
+  std::vector<double> ub(cur_numcols > 0 ? cur_numcols : 1);
+  bool bounded = (cur_numcols > 0) &&
+    (CPXgetlb(e.env, e.lp, lb.data(), 0, cur_numcols - 1) == 0) &&
+    (CPXgetub(e.env, e.lp, ub.data(), 0, cur_numcols - 1) == 0);
+  for (int j = 0; j < objcnt; ++j) {
+    objlb[j] = bounded ? 0 : -CPX_INFBOUND;
+    objub[j] = bounded ? 0 : CPX_INFBOUND;
+    for (int i = 0; bounded && (i < cur_numcols); ++i) {
+      double c = objcoef[j][i];
+      if (c == 0)
+        continue;
+      double low = (c > 0) ? lb[i] : ub[i];
+      double high = (c > 0) ? ub[i] : lb[i];
+      if ((std::abs(low) >= CPX_INFBOUND) || (std::abs(high) >= CPX_INFBOUND)) {
+        objlb[j] = -CPX_INFBOUND;
+        objub[j] = CPX_INFBOUND;
+        break;
+      }
+      objlb[j] += c * low;
+      objub[j] += c * high;
+    }
+  }
+}
+
+bool Problem::lexicographic_weights(const int* objectives, int count,
+    double* weights) const {
+  std::vector<int> step(count);
+  std::vector<double> lower(count), upper(count);
+  for (int i = 0; i < count; ++i) {
+    int j = objectives[i];
+    if ((! objintegral[j]) || (objlb[j] <= -CPX_INFBOUND) ||
+        (objub[j] >= CPX_INFBOUND))
+      return false;
+    step[i] = objgcd[j];
+    lower[i] = objlb[j];
+    upper[i] = objub[j];
+  }
+  return lexicographicWeights(step.data(), lower.data(), upper.data(), count,
+      weights);
+}
+
+bool Problem::weighted_sum_fits(const int* objectives, const double* weights,
+    int count) const {
+  std::vector<double> lower(count), upper(count);
+  for (int i = 0; i < count; ++i) {
+    int j = objectives[i];
+    if ((objlb[j] <= -CPX_INFBOUND) || (objub[j] >= CPX_INFBOUND))
+      return false;
+    lower[i] = objlb[j];
+    upper[i] = objub[j];
+  }
+  return weightedSumBound(weights, lower.data(), upper.data(), count) <=
+    MAX_WEIGHTED;
+}
+
+void Problem::restrict(Env& e, const double* ideal, const double* worst) {
+  for (int j = 0; j < objcnt; ++j) {
+    double low = (objsen == MIN) ? ideal[j] : worst[j];
+    double high = (objsen == MIN) ? worst[j] : ideal[j];
+    objlb[j] = std::max(objlb[j], low);
+    objub[j] = std::min(objub[j], high);
+    if (objsen == MIN)
+      rhs[j] = std::min(rhs[j], worst[j]);
+    else
+      rhs[j] = std::max(rhs[j], worst[j]);
+  }
+  int status = CPXchgrhs(e.env, e.lp, objcnt, conind, rhs);
+  if (status) {
+    std::cerr << "Failed to change constraint rhs" << std::endl;
+  }
 }
 
 int Problem::read_lp_problem(Env& e) {
@@ -30,6 +30,11 @@ class Problem {
                 // all objectives are to be maximised).
     int* conind;
     char* consense;
+    int* objgcd; // Every value objective j can take is a multiple of
+                 // objgcd[j].
+    bool* objintegral; // Is every value of objective j an integer?
+    double* objlb; // Bounds on the values of objective j, from the bounds
+    double* objub; // on the variables. These may be infinite.
 
     double mip_tolerance;
 
@@ -40,9 +45,37 @@ class Problem {
     Problem(const char* filename, Env& env);
     ~Problem();
 
+    /**
+     * Find integer weights for the given objectives, in priority order, such
+     * that optimising the weighted sum gives the lexicographic optimum.
+     * Returns false if some objective may not be integral, if the objective
+     * ranges are not known, or if the weighted sum could be too large to
+     * solve exactly.
+     */
+    bool lexicographic_weights(const int* objectives, int count,
+        double* weights) const;
+
+    /**
+     * Can the sum of the given objectives, with these weights, be solved
+     * exactly? Returns false if some objective range is not known, or if
+     * the sum could exceed MAX_WEIGHTED (see lexweights.h).
+     */
+    bool weighted_sum_fits(const int* objectives, const double* weights,
+        int count) const;
+
+    /**
+     * Every feasible solution has objective j between ideal[j] and
+     * worst[j] (see BoundTask). Use these as the bounds on the value of each
+     * objective, and the worst values as the right-hand sides of the
+     * objective constraints, wherever they are tighter.
+     */
+    void restrict(Env& e, const double* ideal, const double* worst);
+
   private:
     int read_lp_problem(Env& e);
     int read_mop_problem(Env& e);
+    void find_value_lattices(Env& e);
+    void find_value_ranges(Env& e);
     const char* filename_;
 
 };
@@ -64,5 +97,9 @@ inline Problem::~Problem() {
   delete[] rhs;
   delete[] conind;
   delete[] consense;
+  delete[] objgcd;
+  delete[] objintegral;
+  delete[] objlb;
+  delete[] objub;
 }
 #endif /* PROBLEM_H */
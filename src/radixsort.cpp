@@ -0,0 +1,112 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "radixsort.h"
+
+// Below this many solutions, packing costs more than it saves.
+static const size_t MIN_SOLUTIONS = 64;
+
+struct PackedSolution {
+  uint64_t hi;
+  uint64_t lo;
+  const int * solution;
+};
+
+/* Shift the 128-bit key left by bits, and put value in the gap. As every
+ * value is an int, bits is at most 32. */
+static void pushBits(PackedSolution & p, int bits, uint64_t value) {
+  if (bits == 0)
+    return;
+  p.hi = (p.hi << bits) | (p.lo >> (64 - bits));
+  p.lo = (p.lo << bits) | value;
+}
+
+static unsigned byteOf(const PackedSolution & p, int pass) {
+  uint64_t word = (pass < 8) ? p.lo : p.hi;
+  return (word >> (8 * (pass % 8))) & 0xff;
+}
+
+bool radixSortUnique(std::vector<const int *> & solutions, int k) {
+  size_t n = solutions.size();
+  if ((n < MIN_SOLUTIONS) || (k < 1))
+    return false;
+  std::vector<int64_t> lowest(k), highest(k);
+  for (int i = 0; i < k; ++i) {
+    lowest[i] = highest[i] = solutions[0][i];
+  }
+  for (const int * s: solutions) {
+    for (int i = 0; i < k; ++i) {
+      if (s[i] < lowest[i])
+        lowest[i] = s[i];
+      if (s[i] > highest[i])
+        highest[i] = s[i];
+    }
+  }
+  std::vector<int> bits(k, 0);
+  int totalBits = 0;
+  for (int i = 0; i < k; ++i) {
+    uint64_t range = static_cast<uint64_t>(highest[i] - lowest[i]);
+    while ((bits[i] < 64) && ((range >> bits[i]) != 0)) {
+      bits[i]++;
+    }
+    totalBits += bits[i];
+  }
+  if (totalBits > 128)
+    return false;
+
+  // Offsetting from the largest value makes ascending keys descending
+  // solutions.
+  std::vector<PackedSolution> packed(n), sorted(n);
+  for (size_t j = 0; j < n; ++j) {
+    PackedSolution & p = packed[j];
+    p.hi = p.lo = 0;
+    p.solution = solutions[j];
+    for (int i = 0; i < k; ++i) {
+      pushBits(p, bits[i], static_cast<uint64_t>(highest[i] - p.solution[i]));
+    }
+  }
+
+  int passes = (totalBits + 7) / 8;
+  for (int pass = 0; pass < passes; ++pass) {
+    size_t count[256] = { 0 };
+    for (const PackedSolution & p: packed) {
+      count[byteOf(p, pass)]++;
+    }
+    // Nothing to do if every key has the same byte here.
+    if (count[byteOf(packed[0], pass)] == n)
+      continue;
+    size_t start = 0;
+    for (int b = 0; b < 256; ++b) {
+      size_t c = count[b];
+      count[b] = start;
+      start += c;
+    }
+    for (const PackedSolution & p: packed) {
+      sorted[count[byteOf(p, pass)]++] = p;
+    }
+    packed.swap(sorted);
+  }
+
+  size_t keep = 0;
+  for (size_t j = 0; j < n; ++j) {
+    const PackedSolution & p = packed[j];
+    if ((j > 0) && (p.hi == packed[j - 1].hi) && (p.lo == packed[j - 1].lo))
+      continue;
+    solutions[keep++] = p.solution;
+  }
+  solutions.resize(keep);
+  return true;
+}
@@ -0,0 +1,36 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <vector>
+
+/**
+ * Sort solutions into descending lexicographic order of their first k values,
+ * keeping ties in their original order, and then drop all but the first of
+ * each run of equal solutions.
+ *
+ * Each solution is packed into a 128-bit key, by offsetting every value from
+ * the largest value of its objective and using only as many bits as that
+ * objective's range needs. The keys are then sorted with a stable LSD radix
+ * sort, and duplicates found by comparing keys.
+ *
+ * Returns false, leaving solutions untouched, if there are fewer than 64
+ * solutions (where packing costs more than it saves), or if the ranges need
+ * more than 128 bits between them. The caller then has to sort some other
+ * way.
+ */
+bool radixSortUnique(std::vector<const int *> & solutions, int k);
+
+#endif /* RADIXSORT_H */
@@ -0,0 +1,194 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "relaxfile.h"
+
+constexpr char RelaxationFile::MAGIC[];
+constexpr size_t RelaxationFile::HEADER_BYTES;
+constexpr uint32_t RelaxationFile::VERSION;
+constexpr uint32_t RelaxationFile::INFEASIBLE;
+constexpr uint32_t RelaxationFile::MAXIMISE;
+
+RelaxationFile::RelaxationFile(const std::string & filename,
+    const std::string & modelFile, int objcnt) : objcnt_(objcnt),
+    modelHash_(hashFile(modelFile)), recordBytes_(recordBytes(objcnt)),
+    map_(nullptr), mapLen_(0), out_(nullptr) {
+  size_t len = 0;
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+      len = st.st_size;
+    }
+    if ((len > 0) && (! map(fd, len))) {
+      close(fd);
+      return;
+    }
+    close(fd);
+  }
+  if (len > HEADER_BYTES) {
+    // A run that died mid-write can leave part of a record at the end. Drop
+    // it, so that our own records line up.
+    size_t whole = HEADER_BYTES +
+      ((len - HEADER_BYTES) / recordBytes_) * recordBytes_;
+    if ((whole != len) && (truncate(filename.c_str(), whole) != 0)) {
+      std::cerr << "Warning: Could not truncate " << filename;
+      std::cerr << ", not using it." << std::endl;
+      return;
+    }
+  }
+  out_ = fopen(filename.c_str(), "ab");
+  if (out_ == nullptr) {
+    std::cerr << "Warning: Could not open " << filename;
+    std::cerr << " for writing, not using it." << std::endl;
+    return;
+  }
+  if (len == 0) {
+    char header[HEADER_BYTES];
+    uint32_t version = VERSION;
+    uint32_t count = objcnt_;
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    memcpy(header + 8, &version, sizeof(version));
+    memcpy(header + 12, &count, sizeof(count));
+    fwrite(header, 1, HEADER_BYTES, out_);
+  }
+}
+
+RelaxationFile::~RelaxationFile() {
+  if (out_)
+    fclose(out_);
+  if (map_)
+    munmap(map_, mapLen_);
+}
+
+/* Map an existing file, check that we can use it, and index its records. */
+bool RelaxationFile::map(int fd, size_t len) {
+  if (len < HEADER_BYTES) {
+    std::cerr << "Warning: Relaxation file is too short, not using it.";
+    std::cerr << std::endl;
+    return false;
+  }
+  map_ = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map_ == MAP_FAILED) {
+    map_ = nullptr;
+    std::cerr << "Warning: Could not map relaxation file, not using it.";
+    std::cerr << std::endl;
+    return false;
+  }
+  mapLen_ = len;
+  const char * base = static_cast<const char *>(map_);
+  uint32_t version, count;
+  memcpy(&version, base + 8, sizeof(version));
+  memcpy(&count, base + 12, sizeof(count));
+  if ((memcmp(base, MAGIC, sizeof(MAGIC)) != 0) || (version != VERSION) ||
+      (count != static_cast<uint32_t>(objcnt_))) {
+    std::cerr << "Warning: Relaxation file is from a different version or has";
+    std::cerr << " a different number of objectives, not using it.";
+    std::cerr << std::endl;
+    return false;
+  }
+  for (size_t off = HEADER_BYTES; off + recordBytes_ <= len;
+      off += recordBytes_) {
+    uint64_t key;
+    memcpy(&key, base + off, sizeof(key));
+    index_[key].push_back(base + off);
+  }
+  return true;
+}
+
+bool RelaxationFile::find(uint64_t key, const double * ip, Sense sense,
+    double * lp, int * result, bool & infeasible) const {
+  auto entry = index_.find(key);
+  if (entry == index_.end())
+    return false;
+  for (const char * rec: entry->second) {
+    uint32_t flags;
+    memcpy(&flags, rec + sizeof(uint64_t), sizeof(flags));
+    if (((flags & MAXIMISE) != 0) != (sense == MAX))
+      continue;
+    bool inf = (flags & INFEASIBLE) != 0;
+    // Records are 8-byte aligned within a page-aligned mapping.
+    const double * rip = reinterpret_cast<const double *>(rec + 16);
+    const int32_t * rres = reinterpret_cast<const int32_t *>(rip + objcnt_);
+    bool match = true;
+    for (int i = 0; i < objcnt_ && match; ++i) {
+      if (sense == MIN) {
+        /* The stored rhs must be a relaxation of ip, and the stored result
+         * must satisfy ip. */
+        if (rip[i] < ip[i])
+          match = false;
+        else if (!inf && (rres[i] > ip[i]))
+          match = false;
+      } else {
+        if (rip[i] > ip[i])
+          match = false;
+        else if (!inf && (rres[i] < ip[i]))
+          match = false;
+      }
+    }
+    if (match) {
+      infeasible = inf;
+      for (int i = 0; i < objcnt_; ++i) {
+        lp[i] = rip[i];
+        if (! inf)
+          result[i] = rres[i];
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void RelaxationFile::append(uint64_t key, const double * lp,
+    const int * result, bool infeasible, Sense sense) {
+  if (out_ == nullptr)
+    return;
+  std::vector<char> rec(recordBytes_, 0);
+  uint32_t flags = 0;
+  if (infeasible)
+    flags |= INFEASIBLE;
+  if (sense == MAX)
+    flags |= MAXIMISE;
+  memcpy(&rec[0], &key, sizeof(key));
+  memcpy(&rec[sizeof(key)], &flags, sizeof(flags));
+  memcpy(&rec[16], lp, objcnt_ * sizeof(double));
+  if (! infeasible) {
+    for (int i = 0; i < objcnt_; ++i) {
+      int32_t r = result[i];
+      memcpy(&rec[16 + objcnt_ * sizeof(double) + i * sizeof(r)], &r,
+          sizeof(r));
+    }
+  }
+  std::unique_lock<std::mutex> lk(mutex_);
+  fwrite(&rec[0], 1, recordBytes_, out_);
+}
+
+uint64_t RelaxationFile::hashFile(const std::string & filename) {
+  std::ifstream in(filename, std::ios::binary);
+  uint64_t h = hash(nullptr, 0);
+  char buf[65536];
+  while (in) {
+    in.read(buf, sizeof(buf));
+    h = hash(buf, in.gcount(), h);
+  }
+  return h;
+}
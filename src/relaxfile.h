@@ -0,0 +1,130 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef RELAXFILE_H
+#define RELAXFILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sense.h"
+
+/**
+ * An on-disk store of relaxations, kept across runs.
+ *
+ * The file starts with a 16 byte header (magic, version, objective count)
+ * followed by fixed-size records. Each record holds a key, some flags, the
+ * right-hand side that was solved and, if it was feasible, the result. The
+ * key is a hash of the model file and the (ordered) objectives that the
+ * solving task used, so one file can hold records for many instances.
+ *
+ * Records that exist when the file is opened are memory-mapped and indexed
+ * by key. Records appended during a run are written straight to the end of
+ * the file, and are only seen by later runs.
+ */
+class RelaxationFile {
+  public:
+    static constexpr char MAGIC[8] = { 'K', 'P', 'P', 'M', 'R', 'L', 'X', '1' };
+    static constexpr size_t HEADER_BYTES = 16;
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t INFEASIBLE = 1;
+    static constexpr uint32_t MAXIMISE = 2;
+
+    /**
+     * Open (or create) the file, for a model read from modelFile with
+     * objcnt objectives. If the file cannot be used, a warning is printed
+     * and valid() returns false.
+     */
+    RelaxationFile(const std::string & filename, const std::string & modelFile,
+        int objcnt);
+    ~RelaxationFile();
+
+    bool valid() const;
+
+    /**
+     * The key for relaxations found by a task solving the given objectives,
+     * in the given order.
+     */
+    uint64_t key(const int * objectives, int count) const;
+
+    /**
+     * Look for a stored relaxation of ip under the given key. If one is found,
+     * its right-hand side is copied into lp and its result (if feasible) into
+     * result.
+     */
+    bool find(uint64_t key, const double * ip, Sense sense, double * lp,
+        int * result, bool & infeasible) const;
+
+    void append(uint64_t key, const double * lp, const int * result,
+        bool infeasible, Sense sense);
+
+    /**
+     * Number of bytes used by one record for objcnt objectives.
+     */
+    static size_t recordBytes(int objcnt);
+
+    /**
+     * 64-bit FNV-1a hash, continuing from seed.
+     */
+    static uint64_t hash(const void * data, size_t len,
+        uint64_t seed = 14695981039346656037ULL);
+
+    static uint64_t hashFile(const std::string & filename);
+
+  private:
+    bool map(int fd, size_t len);
+
+    int objcnt_;
+    uint64_t modelHash_;
+    size_t recordBytes_;
+
+    // The mapped region, if any.
+    void * map_;
+    size_t mapLen_;
+
+    // Records present at startup, indexed by key.
+    std::unordered_map<uint64_t, std::vector<const char *> > index_;
+
+    FILE * out_;
+    std::mutex mutex_;
+};
+
+inline bool RelaxationFile::valid() const {
+  return out_ != nullptr;
+}
+
+inline size_t RelaxationFile::recordBytes(int objcnt) {
+  size_t len = 2 * sizeof(uint64_t) + objcnt * (sizeof(double) + sizeof(int32_t));
+  return (len + 7) & ~static_cast<size_t>(7);
+}
+
+inline uint64_t RelaxationFile::hash(const void * data, size_t len,
+    uint64_t seed) {
+  const unsigned char * c = static_cast<const unsigned char *>(data);
+  uint64_t h = seed;
+  for (size_t i = 0; i < len; ++i) {
+    h ^= c[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+inline uint64_t RelaxationFile::key(const int * objectives, int count) const {
+  return hash(objectives, count * sizeof(int), modelHash_);
+}
+
+#endif /* RELAXFILE_H */
@@ -0,0 +1,199 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <iomanip>
+#include <sstream>
+
+#include "resultwriter.h"
+
+static std::string jsonString(const std::string & s) {
+  std::string res("\"");
+  for (char c: s) {
+    if ((c == '"') || (c == '\\'))
+      res += '\\';
+    res += c;
+  }
+  return res + "\"";
+}
+
+void Summary::add(double value, const std::string & label, int precision,
+    int width) {
+  lines_.push_back(Line{ value, label, precision, width });
+}
+
+std::string Summary::number(const Line & line, int width) {
+  std::ostringstream out;
+  if (line.precision >= 0)
+    out << std::fixed << std::setprecision(line.precision);
+  out << std::setw(width) << line.value;
+  return out.str();
+}
+
+std::string Summary::text() const {
+  std::string res;
+  for (const Line & line: lines_) {
+    res += number(line, line.width) + line.label + '\n';
+  }
+  return res;
+}
+
+std::string Summary::json() const {
+  std::string res("{");
+  for (const Line & line: lines_) {
+    size_t start = line.label.find_first_not_of(" \t");
+    if (start == std::string::npos)
+      start = line.label.size();
+    if (res.size() > 1)
+      res += ',';
+    res += jsonString(line.label.substr(start)) + ':' + number(line, 0);
+  }
+  return res + "}";
+}
+
+bool ResultWriter::parseFormat(const std::string & name, Format & format) {
+  if (name == "tsv") {
+    format = TSV;
+  } else if (name == "csv") {
+    format = CSV;
+  } else if (name == "jsonl") {
+    format = JSONL;
+  } else if (name == "binary") {
+    format = BINARY;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+ResultWriter::ResultWriter(std::ostream & out, Format format, int objcnt,
+    bool stream, const std::string & version) : out_(out), format_(format),
+    objcnt_(objcnt), stream_(stream), version_(version), closing_(false) {
+  switch (format_) {
+    case TSV:
+    case CSV:
+      out_ << "\nUsing k-PPM at " << version_ << "\n";
+      break;
+    case JSONL:
+      out_ << "{\"version\":" << jsonString("k-PPM at " + version_) << "}\n";
+      break;
+    case BINARY:
+      {
+        uint32_t header[2] = { VERSION, static_cast<uint32_t>(objcnt_) };
+        out_.write("KPPM", 4);
+        out_.write(reinterpret_cast<const char *>(header), sizeof(header));
+      }
+      break;
+  }
+  if (stream_)
+    out_.flush();
+  thread_ = std::thread(&ResultWriter::run, this);
+}
+
+ResultWriter::~ResultWriter() {
+  stop();
+}
+
+void ResultWriter::write(const int * solution) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_.insert(pending_.end(), solution, solution + objcnt_);
+  }
+  ready_.notify_one();
+}
+
+void ResultWriter::write(const std::vector<const int *> & solutions) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (const int * s: solutions) {
+      pending_.insert(pending_.end(), s, s + objcnt_);
+    }
+  }
+  ready_.notify_one();
+}
+
+/* Take whatever is pending, and write it out as one batch. Solutions written
+ * while a batch is being encoded wait for the next batch. */
+void ResultWriter::run() {
+  std::vector<int> batch;
+  std::string buf;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_.wait(lock, [this] { return closing_ || ! pending_.empty(); });
+      if (pending_.empty())
+        return;
+      batch.swap(pending_);
+    }
+    buf.clear();
+    encode(batch, buf);
+    batch.clear();
+    out_.write(buf.data(), buf.size());
+    if (stream_)
+      out_.flush();
+  }
+}
+
+void ResultWriter::encode(const std::vector<int> & values,
+    std::string & buf) const {
+  size_t count = values.size() / objcnt_;
+  if (format_ == BINARY) {
+    uint32_t n = static_cast<uint32_t>(count);
+    buf.append(reinterpret_cast<const char *>(&n), sizeof(n));
+    for (int o = 0; o < objcnt_; ++o) {
+      for (size_t i = 0; i < count; ++i) {
+        int32_t v = values[i * objcnt_ + o];
+        buf.append(reinterpret_cast<const char *>(&v), sizeof(v));
+      }
+    }
+    return;
+  }
+  const char * sep = (format_ == TSV) ? "\t" : ",";
+  for (size_t i = 0; i < count; ++i) {
+    const int * s = &values[i * objcnt_];
+    if (format_ == JSONL)
+      buf += '[';
+    buf += std::to_string(s[0]);
+    for (int o = 1; o < objcnt_; ++o) {
+      buf += sep;
+      buf += std::to_string(s[o]);
+    }
+    if (format_ == JSONL)
+      buf += ']';
+    buf += '\n';
+  }
+}
+
+void ResultWriter::stop() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  ready_.notify_one();
+  if (thread_.joinable())
+    thread_.join();
+}
+
+void ResultWriter::finish(const Summary & summary) {
+  stop();
+  if (format_ == BINARY) {
+    uint32_t end = 0;
+    out_.write(reinterpret_cast<const char *>(&end), sizeof(end));
+    out_ << "\nUsing k-PPM at " << version_ << "\n";
+  }
+  if (format_ == JSONL) {
+    out_ << "{\"summary\":" << summary.json() << "}\n";
+  } else {
+    out_ << "\n---\n" << summary.text();
+  }
+  out_.flush();
+}
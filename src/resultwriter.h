@@ -0,0 +1,128 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * The summary written after the solutions: one number per line, each
+ * followed by a label saying what it counts. The label includes whatever
+ * separates it from the number.
+ */
+class Summary {
+  public:
+    /**
+     * Add a line. The number is shown with precision digits after the point
+     * (or, if precision is negative, as a stream shows a double by default),
+     * padded to at least width characters in text.
+     */
+    void add(double value, const std::string & label, int precision = 0,
+        int width = 0);
+
+    /**
+     * One line per number, in the order added.
+     */
+    std::string text() const;
+
+    /**
+     * One JSON object, keyed by label (less its leading separator).
+     */
+    std::string json() const;
+
+  private:
+    struct Line {
+      double value;
+      std::string label;
+      int precision;
+      int width;
+    };
+
+    static std::string number(const Line & line, int width);
+
+    std::vector<Line> lines_;
+};
+
+/**
+ * Writes solutions to the output file from a thread of its own, so that the
+ * tasks that find them never wait on the disk.
+ *
+ * Solutions are copied as they are written, and are then formatted in
+ * batches. If stream is set, the output is flushed after each batch, so a
+ * reader sees every solution soon after it is written. Otherwise the output
+ * is only flushed by finish().
+ *
+ * The formats are:
+ * TSV - one solution per line, tab-separated.
+ * CSV - one solution per line, comma-separated.
+ * JSONL - one JSON array per solution. The preamble and summary are JSON
+ *   objects too, the summary keyed by label.
+ * BINARY - a 12 byte header ("KPPM", version, objective count) followed by
+ *   blocks of solutions. Each block is a count, then that many values of the
+ *   first objective, then of the second, and so on. A block with a count of
+ *   0 ends the solutions, and the summary follows as text. All values are
+ *   32-bit integers in native byte order.
+ */
+class ResultWriter {
+  public:
+    enum Format { TSV, CSV, JSONL, BINARY };
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * Set format from its name, returning false if there is no such format.
+     */
+    static bool parseFormat(const std::string & name, Format & format);
+
+    /**
+     * Write the preamble, naming the version of k-PPM, and start the writer
+     * thread.
+     */
+    ResultWriter(std::ostream & out, Format format, int objcnt, bool stream,
+        const std::string & version);
+    ~ResultWriter();
+
+    void write(const int * solution);
+    void write(const std::vector<const int *> & solutions);
+
+    /**
+     * Wait for every solution to be written, then write the summary.
+     */
+    void finish(const Summary & summary);
+
+  private:
+    void run();
+    void encode(const std::vector<int> & values, std::string & buf) const;
+    void stop();
+
+    std::ostream & out_;
+    Format format_;
+    int objcnt_;
+    bool stream_;
+    std::string version_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    // objcnt_ values per solution, waiting to be written.
+    std::vector<int> pending_;
+    bool closing_;
+    std::thread thread_;
+};
+
+#endif /* RESULTWRITER_H */
@@ -0,0 +1,201 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "searchregion.h"
+#include "types.h"
+
+extern std::atomic<bool> interrupted;
+
+SearchRegion::SearchRegion(int objcnt, Sense sense,
+    const std::vector<int> & lattice, const double * rhs) :
+    objcnt_(objcnt), sense_(sense), lattice_(lattice), objectives_(objcnt),
+    open_(objcnt, (sense == MIN) ? -INF : INF), zones_(objcnt), inFlight_(0),
+    known_(objcnt, sense) {
+  for (int i = 0; i < objcnt_; ++i) {
+    objectives_[i] = i;
+  }
+  if (lattice_.empty())
+    lattice_.assign(objcnt_, 1);
+  newZone(rhs);
+}
+
+/* Add a zone with the given bounds. */
+Box * SearchRegion::newZone(const double * rhs) {
+  std::vector<double> bounds(rhs, rhs + objcnt_);
+  Box * b = (sense_ == MIN) ?
+    new Box(bounds.data(), open_.data(), objectives_.data(), objcnt_) :
+    new Box(open_.data(), bounds.data(), objectives_.data(), objcnt_);
+  zones_.insert(b);
+  return b;
+}
+
+void SearchRegion::drop(Box * b) {
+  taken_.erase(b);
+  zones_.remove(b);
+}
+
+/* The zone with exactly the bounds rhs, if it is still open. */
+Box * SearchRegion::zone(const double * rhs) const {
+  for (Box * b: zones_) {
+    bool same = true;
+    for (int i = 0; same && (i < objcnt_); ++i) {
+      same = (bound(b, i) == rhs[i]);
+    }
+    if (same)
+      return b;
+  }
+  return nullptr;
+}
+
+/* The log of the volume of zone b, between the best values found and its
+ * bounds. Only used to compare zones. */
+double SearchRegion::size(const Box * b) const {
+  if (ideal_.empty())
+    return 0;
+  double sum = 0;
+  for (int i = 0; i < objcnt_; ++i) {
+    double u = (sense_ == MIN) ? std::min(bound(b, i), nadir_[i]) :
+      std::max(bound(b, i), nadir_[i]);
+    sum += std::log(std::abs(u - ideal_[i]) + lattice_[i]);
+  }
+  return sum;
+}
+
+/* Replace every zone holding z by its parts that z does not dominate.
+ * Returns false if no zone holds z. */
+bool SearchRegion::update(const int * z) {
+  if (ideal_.empty()) {
+    ideal_.assign(z, z + objcnt_);
+    nadir_.assign(z, z + objcnt_);
+  }
+  for (int i = 0; i < objcnt_; ++i) {
+    ideal_[i] = (sense_ == MIN) ? std::min<double>(ideal_[i], z[i]) :
+      std::max<double>(ideal_[i], z[i]);
+    nadir_[i] = (sense_ == MIN) ? std::max<double>(nadir_[i], z[i]) :
+      std::min<double>(nadir_[i], z[i]);
+  }
+  std::vector<Box *> hit;
+  for (Box * b: zones_) {
+    if (b->contains(z))
+      hit.push_back(b);
+  }
+  if (hit.empty())
+    return false;
+  std::vector<double> parts;
+  for (Box * b: hit) {
+    for (int j = 0; j < objcnt_; ++j) {
+      size_t start = parts.size();
+      for (int i = 0; i < objcnt_; ++i) {
+        parts.push_back(bound(b, i));
+      }
+      parts[start + j] = (sense_ == MIN) ? z[j] - lattice_[j] :
+        z[j] + lattice_[j];
+    }
+    drop(b);
+  }
+  // Keep only the parts that no other zone holds. Of two equal parts, the
+  // first is kept.
+  size_t count = parts.size() / objcnt_;
+  for (size_t p = 0; p < count; ++p) {
+    const double * part = &parts[p * objcnt_];
+    bool redundant = false;
+    for (size_t q = 0; (! redundant) && (q < count); ++q) {
+      if (q == p)
+        continue;
+      const double * other = &parts[q * objcnt_];
+      redundant = covers(other, part) && ((q < p) || ! covers(part, other));
+    }
+    for (auto it = zones_.begin(); (! redundant) && (it != zones_.end());
+        ++it) {
+      std::vector<double> other(objcnt_);
+      for (int i = 0; i < objcnt_; ++i) {
+        other[i] = bound(*it, i);
+      }
+      redundant = covers(other.data(), part);
+    }
+    if (! redundant)
+      newZone(part);
+  }
+  return true;
+}
+
+/* Give back a zone that was taken. */
+void SearchRegion::release() {
+  inFlight_--;
+  cond_.notify_all();
+}
+
+bool SearchRegion::next(double * rhs) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    if (interrupted)
+      return false;
+    Box * best = nullptr;
+    double bestSize = 0;
+    for (Box * b: zones_) {
+      if (taken_.count(b) != 0)
+        continue;
+      double s = size(b);
+      if ((best == nullptr) || (s > bestSize)) {
+        best = b;
+        bestSize = s;
+      }
+    }
+    if (best == nullptr) {
+      if (inFlight_ == 0)
+        return false;
+      cond_.wait(lock);
+      continue;
+    }
+    for (int i = 0; i < objcnt_; ++i) {
+      rhs[i] = bound(best, i);
+    }
+    const Result * r = known_.find(rhs, sense_);
+    if (r == nullptr) {
+      taken_.insert(best);
+      inFlight_++;
+      return true;
+    }
+    if (r->infeasible) {
+      drop(best);
+    } else {
+      // A point we know lies in this zone, so it was found after the zone
+      // was made. The zone is replaced.
+      update(r->result);
+    }
+  }
+}
+
+bool SearchRegion::found(const double * rhs, const int * z) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  known_.insert(rhs, z, false);
+  Box * b = zone(rhs);
+  if (b != nullptr)
+    taken_.erase(b);
+  bool isNew = update(z);
+  release();
+  return isNew;
+}
+
+void SearchRegion::empty(const double * rhs) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  known_.insert(rhs, nullptr, true);
+  Box * b = zone(rhs);
+  if (b != nullptr)
+    drop(b);
+  release();
+}
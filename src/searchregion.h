@@ -0,0 +1,115 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef SEARCHREGION_H
+#define SEARCHREGION_H
+
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "box.h"
+#include "boxstore.h"
+#include "sense.h"
+#include "solutions.h"
+
+/**
+ * The part of objective space that may still hold nondominated points, as
+ * a set of search zones, for the defining point method.
+ *
+ * Each zone is a Box bounded on one side only, by a local upper bound (or
+ * lower bound, when maximising) on every objective. Nothing found so far lies
+ * in any zone, and every nondominated point not yet found lies in one. When a
+ * point is found, each zone holding it is replaced by one zone per objective,
+ * that is strictly better than the point on that objective. New zones that
+ * lie inside another zone are dropped, so each zone is defined by the points
+ * on its boundary.
+ *
+ * Zones are handed out by next() to be solved, largest first, and any number
+ * can be out at once. Every zone is unbounded on its open side, so its size
+ * is measured from the best value found so far on each objective, with any
+ * infinite bound cut back to the worst value found. A Solutions store
+ * remembers every solved zone, so a zone inside one known to be empty is
+ * dropped without a solve.
+ *
+ * All public member functions lock the region, so it can be shared between
+ * threads.
+ */
+class SearchRegion {
+  public:
+    SearchRegion(int objcnt, Sense sense, const std::vector<int> & lattice,
+        const double * rhs);
+
+    /**
+     * Take a zone to solve, and copy its bounds into rhs. If every zone is
+     * out, wait for one to come back. Returns false once there is nothing
+     * left to solve, or once we are interrupted.
+     */
+    bool next(double * rhs);
+
+    /**
+     * Return the zone with bounds rhs, in which z was found. Returns true if
+     * z was not known before.
+     */
+    bool found(const double * rhs, const int * z);
+
+    /**
+     * Return the zone with bounds rhs, which holds no feasible point.
+     */
+    void empty(const double * rhs);
+
+  private:
+    double bound(const Box * b, int i) const;
+    double size(const Box * b) const;
+    bool covers(const double * a, const double * b) const;
+    Box * zone(const double * rhs) const;
+    Box * newZone(const double * rhs);
+    void drop(Box * b);
+    bool update(const int * z);
+    void release();
+
+    int objcnt_;
+    Sense sense_;
+    std::vector<int> lattice_;
+    std::vector<int> objectives_;
+    // The open side of every zone.
+    std::vector<double> open_;
+    // The best and worst value found on each objective, empty until the
+    // first point is found.
+    std::vector<double> ideal_;
+    std::vector<double> nadir_;
+    BoxStore zones_;
+    // Zones that are being solved.
+    std::set<const Box *> taken_;
+    int inFlight_;
+    Solutions known_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+/* The bound of zone b on objective i. */
+inline double SearchRegion::bound(const Box * b, int i) const {
+  return (sense_ == MIN) ? b->upper(i) : b->lower(i);
+}
+
+/* Does the zone with bounds a hold all of the zone with bounds b? */
+inline bool SearchRegion::covers(const double * a, const double * b) const {
+  for (int i = 0; i < objcnt_; ++i) {
+    if ((sense_ == MIN) ? (a[i] < b[i]) : (a[i] > b[i]))
+      return false;
+  }
+  return true;
+}
+
+#endif /* SEARCHREGION_H */
@@ -0,0 +1,56 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef SOLUTIONBLOCK_H
+#define SOLUTIONBLOCK_H
+
+#include <memory>
+#include <vector>
+
+#include "arena.h"
+
+/**
+ * The solutions of a finished task, as handed on to the tasks that use them.
+ * A block is never changed once made, so it can be shared between threads.
+ *
+ * A block owns the arena holding the solutions its task found itself. Any
+ * other solution came from an earlier block, and is not copied: the block
+ * just keeps a reference to that earlier block, so it lives as long as
+ * anything points into it.
+ */
+class SolutionBlock {
+  public:
+    SolutionBlock(Arena && owned,
+        std::vector<std::shared_ptr<const SolutionBlock>> && sources,
+        const std::vector<const int *> & solutions);
+
+    const std::vector<const int *> & solutions() const;
+
+  private:
+    Arena owned_;
+    std::vector<std::shared_ptr<const SolutionBlock>> sources_;
+    std::vector<const int *> solutions_;
+};
+
+inline SolutionBlock::SolutionBlock(Arena && owned,
+    std::vector<std::shared_ptr<const SolutionBlock>> && sources,
+    const std::vector<const int *> & solutions) :
+    owned_(std::move(owned)), sources_(std::move(sources)),
+    solutions_(solutions) {
+}
+
+inline const std::vector<const int *> & SolutionBlock::solutions() const {
+  return solutions_;
+}
+
+#endif /* SOLUTIONBLOCK_H */
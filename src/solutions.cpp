@@ -11,9 +11,15 @@ You should have received a copy of the GNU General Public License along with thi
 
 */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstring>
 #include <mutex>
+#include <new>
+#include <vector>
 
+#include "kernels.h"
 #include "result.h"
 #include "solutions.h"
 
@@ -21,123 +27,472 @@ You should have received a copy of the GNU General Public License along with thi
 extern std::mutex debug_mutex;
 #endif
 
-const Result * Solutions::find(const double *ip, const Sense sense) const {
-  bool t1,t3;
-  for (auto& res: store_) {
-
-    t1 = true;
-    t3 = true;
-    if (sense == MIN) {
-      for (int i = 0; i < objective_count; i++){
-        /* t1: All values of candidate must be >= than ip */
-        if (res->ip[i] < ip[i]) {
-          t1 = false;
-          break;
-        }
-        /* t3: All values of candidate result must be <= than ip */
-        if (!res->infeasible) {
-          if (res->result[i] > ip[i]) {
-            t3 = false;
-            break;
-          }
+extern std::atomic<long> cachehits;
+extern std::atomic<long> cachemisses;
+extern std::atomic<long> cacheevictions;
+extern std::atomic<long> diskhits;
+
+/* The first stored result whose rhs relaxes ip, and which satisfies ip. */
+template <int K, Sense S>
+struct FeasibleScan {
+  static std::list<Result*>::iterator run(std::list<Result*> & store,
+      const double * ip, int count) {
+    auto it = store.begin();
+    for (; it != store.end(); ++it) {
+      const Result * res = *it;
+      if (relaxes<K, S>(res->ip, ip, count) &&
+          satisfies<K, S>(res->result, ip, count))
+        break;
+    }
+    return it;
+  }
+};
+
+/* The first row of the infeasibility frontier which relaxes ip. */
+template <int K, Sense S>
+struct InfeasibleScan {
+  static const double * run(const std::vector<double> & rows,
+      const double * ip, int count) {
+    const int n = kernelWidth<K>(count);
+    for (size_t row = 0; row < rows.size(); row += n) {
+      if (relaxes<K, S>(&rows[row], ip, count))
+        return &rows[row];
+    }
+    return nullptr;
+  }
+};
+
+/* Drop every row of the frontier that lp relaxes, along with its entry in
+ * used, returning the number of values kept. */
+template <int K, Sense S>
+struct InfeasiblePrune {
+  static size_t run(std::vector<double> & rows,
+      std::vector<uint64_t> & used, const double * lp, int count) {
+    const int n = kernelWidth<K>(count);
+    size_t keep = 0;
+    for (size_t row = 0; row < rows.size(); row += n) {
+      const double * other = &rows[row];
+      if (! relaxes<K, S>(lp, other, count)) {
+        if (keep != row) {
+          std::copy(other, other + n, &rows[keep]);
+          used[keep / n] = used[row / n];
         }
+        keep += n;
+      }
+    }
+    used.resize(keep / n);
+    return keep;
+  }
+};
+
+void Solutions::specialise() {
+  scanFeasible_ = selectKernel<FeasibleScan>(objective_count, sense_);
+  scanInfeasible_ = selectKernel<InfeasibleScan>(objective_count, sense_);
+  pruneInfeasible_ = selectKernel<InfeasiblePrune>(objective_count, sense_);
+}
+
+const Result * Solutions::find(const double *ip, const Sense sense,
+    Solutions * shared) {
+  std::unique_lock<std::mutex> lk(mutex);
+  return findLocked(ip, sense, shared);
+}
+
+/* Look for a relaxation in other, and if one is found copy it into this
+ * store. Returns our copy, so that the caller never holds a pointer into a
+ * store that another thread may evict from. Our own mutex is held, and
+ * other's is taken here; no store ever locks in the other order. */
+const Result * Solutions::importLocked(Solutions & other, const double *ip) {
+  // Per-thread scratch, so that lookups do not allocate.
+  static thread_local std::vector<double> lp;
+  static thread_local std::vector<int> result;
+  lp.resize(objective_count);
+  result.resize(objective_count);
+  bool infeasible;
+  {
+    std::unique_lock<std::mutex> lk(other.mutex);
+    const double * row = other.findInfeasible(ip);
+    if (row != nullptr) {
+      infeasible = true;
+      for (int i = 0; i < objective_count; ++i) {
+        lp[i] = row[i];
       }
     } else {
-      for (int i = 0; i < objective_count; i++){
-        /* t1: All values of candidate must be <= than ip */
-        if (res->ip[i] > ip[i]) {
-          t1 = false;
-          break;
-        }
-        /* t3: All values of candidate result must be >= than ip */
-        if (!res->infeasible) {
-          if (res->result[i] < ip[i]) {
-            t3 = false;
-            break;
-          }
-        }
+      const Result * r = other.findFeasible(ip);
+      if (r == nullptr)
+        return nullptr;
+      infeasible = false;
+      for (int i = 0; i < objective_count; ++i) {
+        lp[i] = r->ip[i];
+        result[i] = r->result[i];
       }
     }
-    /* If all conditions are met copy problem & solution and return */
-    if (t1 && t3) {
+  }
+  return insertLocked(lp.data(), result.data(), infeasible);
+}
+
+/* Each lookup counts as exactly one hit or one miss, wherever it is
+ * answered. */
+const Result * Solutions::findLocked(const double *ip, const Sense sense,
+    Solutions * shared) {
+  bool scan = true;
+  long cell = gridCell(ip);
+  if (cell >= 0) {
+    int value = grid_[cell];
+    if (value == -1) {
+      cachehits++;
+      return &infeasibleResult_;
+    }
+    if (value > 0) {
+      cachehits++;
+      return gridResults_[value - 1];
+    }
+    // Every relaxation we hold has marked the grid, so none of them fits.
+    scan = (unpainted_ > 0);
+  }
+  if (scan && (findInfeasible(ip) != nullptr)) {
 #if defined(DEBUG) && defined(DEBUG_SOLUTION_SEARCH)
-      debug_mutex.lock();
-      std::cout << " relaxed to ";
-      for(int i = 0; i < objective_count; ++i) {
-        if (res->ip[i] > 1e19)
-          std::cout << "∞,";
-        else if (res->ip[i] < -1e19)
-          std::cout << "-∞,";
-        else
-          std::cout << res->ip[i] << ",";
-      }
-      std::cout << " soln is ";
-      if (res->infeasible) {
-        std::cout << "infeasible";
-      } else {
-        for(int i = 0; i < objective_count; ++i) {
-          std::cout << res->result[i] << ",";
-        }
-      }
-      std::cout << std::endl;
-      debug_mutex.unlock();
+    debug_mutex.lock();
+    std::cout << " relaxation is infeasible" << std::endl;
+    debug_mutex.unlock();
 #endif
-      return res;
-    }
+    cachehits++;
+    return &infeasibleResult_;
+  }
+  const Result * res = scan ? findFeasible(ip) : nullptr;
+  if (res != nullptr) {
+    cachehits++;
+    return res;
   }
 #if defined(DEBUG) && defined(DEBUG_SOLUTION_SEARCH)
   debug_mutex.lock();
   std::cout << " no relaxation found" << std::endl;
   debug_mutex.unlock();
 #endif
+  if (file_) {
+    static thread_local std::vector<double> lp;
+    static thread_local std::vector<int> result;
+    lp.resize(objective_count);
+    result.resize(objective_count);
+    bool infeasible;
+    if (file_->find(key_, ip, sense, lp.data(), result.data(), infeasible)) {
+      diskhits++;
+      return insertLocked(lp.data(), result.data(), infeasible);
+    }
+  }
+  if (shared != nullptr) {
+    res = importLocked(*shared, ip);
+    if (res != nullptr) {
+      cachehits++;
+      return res;
+    }
+  }
+  cachemisses++;
   return nullptr;
 }
-void Solutions::insert(const double *lp, const int *result,
-    const bool infeasible) {
-  Result * r = new Result;
-  r->objective_count = objective_count;
-  r->ip = new double[objective_count];
-  for (int i = 0; i < objective_count; ++i) {
-    r->ip[i] = lp[i];
+
+/* Find the best weighted sum of the given objectives over every stored
+ * result that satisfies ip. The optimum of that sum under ip is at least this
+ * good. Returns false if no stored result satisfies ip. */
+bool Solutions::bound(const double * ip, const int * objectives,
+    const double * weights, int count, double & value) {
+  std::unique_lock<std::mutex> lk(mutex);
+  bool found = false;
+  for (const Result * r: store_) {
+    bool feasible = (sense_ == MIN) ?
+      satisfies<0, MIN>(r->result, ip, objective_count) :
+      satisfies<0, MAX>(r->result, ip, objective_count);
+    if (! feasible)
+      continue;
+    double sum = 0;
+    for (int i = 0; i < count; ++i) {
+      sum += weights[i] * r->result[objectives[i]];
+    }
+    if ((! found) || ((sense_ == MIN) ? (sum < value) : (sum > value))) {
+      value = sum;
+      found = true;
+    }
   }
+  return found;
+}
+
+/* Find a row of the infeasibility frontier which is a relaxation of ip. */
+const double * Solutions::findInfeasible(const double *ip) {
+  const double * row = scanInfeasible_(infeasible_, ip, objective_count);
+  if (row != nullptr)
+    infeasibleUsed_[(row - infeasible_.data()) / objective_count] = ++clock_;
+  return row;
+}
+
+const Result * Solutions::findFeasible(const double *ip) {
+  auto it = scanFeasible_(store_, ip, objective_count);
+  if (it != store_.end()) {
+    Result * res = *it;
+#if defined(DEBUG) && defined(DEBUG_SOLUTION_SEARCH)
+    debug_mutex.lock();
+    std::cout << " relaxed to ";
+    for(int i = 0; i < objective_count; ++i) {
+      if (res->ip[i] > 1e19)
+        std::cout << "∞,";
+      else if (res->ip[i] < -1e19)
+        std::cout << "-∞,";
+      else
+        std::cout << res->ip[i] << ",";
+    }
+    std::cout << " soln is ";
+    for(int i = 0; i < objective_count; ++i) {
+      std::cout << res->result[i] << ",";
+    }
+    std::cout << std::endl;
+    debug_mutex.unlock();
+#endif
+    // Most recently hit goes to the front, so it is evicted last (and
+    // found sooner next time).
+    store_.splice(store_.begin(), store_, it);
+    lastUse(res) = ++clock_;
+    return res;
+  }
+  return nullptr;
+}
+
+const Result * Solutions::insert(const double *lp, const int *result,
+    const bool infeasible) {
+  std::unique_lock<std::mutex> lk(mutex);
+  return insertLocked(lp, result, infeasible);
+}
+
+const Result * Solutions::insertLocked(const double *lp, const int *result,
+    const bool infeasible) {
   if (infeasible) {
-    r->infeasible = true;
-    r->result = nullptr;
-  } else {
-    r->infeasible = false;
-    r->result = new int[objective_count];
-    for (int i = 0; i < objective_count; ++i) {
-      r->result[i] = result[i];
+    insertInfeasible(lp);
+    if ((! grid_.empty()) && (paint(lp, nullptr, -1) < 0))
+      unpainted_++;
+    evict();
+    return &infeasibleResult_;
+  }
+  Result * r = newResult(lp, result);
+  store_.push_front(r);
+  if (! grid_.empty()) {
+    Result * g = newResult(lp, result);
+    gridResults_.push_back(g);
+    long painted = paint(lp, result, gridResults_.size());
+    if (painted <= 0) {
+      gridResults_.pop_back();
+      release(g);
+      if (painted < 0)
+        unpainted_++;
     }
   }
-  store_.push_back(r);
+  evict();
+  return r;
 }
 
-void Solutions::insert(const Result *otherR) {
-  Result * r = new Result;
-  r->objective_count = objective_count;
-  r->ip = new double[objective_count];
+/* Set up a dense grid over the objectives dims[0..count-1], covering the
+ * integer values lower[i]..upper[i] of each. base gives the right-hand side
+ * of every other objective. Nothing is set up if the grid would have more
+ * than maxCells cells, or if anything has already been stored. */
+bool Solutions::index(const double * base, const int * dims,
+    const double * lower, const double * upper, int count, size_t maxCells) {
+  std::unique_lock<std::mutex> lk(mutex);
+  if ((maxCells == 0) || (count == 0) || (! store_.empty()) ||
+      (! infeasible_.empty())) {
+    return false;
+  }
+  size_t cells = 1;
+  for (int d = 0; d < count; ++d) {
+    if ((lower[d] != std::floor(lower[d])) ||
+        (upper[d] != std::floor(upper[d])) || (upper[d] < lower[d])) {
+      return false;
+    }
+    double extent = upper[d] - lower[d] + 1;
+    if (extent > maxCells / cells)
+      return false;
+    cells *= static_cast<size_t>(extent);
+  }
+  // The grid is charged to our limit, so it must leave room for the list.
+  if ((maxEntries_ > 0) && (cells * sizeof(int) / entryBytes(objective_count)
+        >= maxEntries_ / 2)) {
+    return false;
+  }
+  gridDims_.assign(dims, dims + count);
+  inGrid_.assign(objective_count, false);
+  gridLower_.resize(count);
+  gridExtent_.resize(count);
+  for (int d = 0; d < count; ++d) {
+    inGrid_[dims[d]] = true;
+    gridLower_[d] = static_cast<long>(lower[d]);
+    gridExtent_[d] = static_cast<long>(upper[d] - lower[d] + 1);
+  }
+  gridBase_.assign(base, base + objective_count);
+  grid_.assign(cells, 0);
+  return true;
+}
+
+/* The grid cell for ip, or -1 if ip is not on the grid. */
+long Solutions::gridCell(const double *ip) const {
+  if (grid_.empty())
+    return -1;
+  for (int i = 0; i < objective_count; ++i) {
+    if ((! inGrid_[i]) && (ip[i] != gridBase_[i]))
+      return -1;
+  }
+  long cell = 0;
+  for (size_t d = 0; d < gridDims_.size(); ++d) {
+    double c = ip[gridDims_[d]] - gridLower_[d];
+    if ((c < 0) || (c >= gridExtent_[d]) || (c != std::floor(c)))
+      return -1;
+    cell = cell * gridExtent_[d] + static_cast<long>(c);
+  }
+  return cell;
+}
+
+/* Mark value in every unmarked grid cell that the relaxation lp (with the
+ * given result, or nullptr if infeasible) answers. Returns the number of
+ * cells marked, or -1 if the relaxation does not fit the rest of the grid's
+ * right-hand side. */
+long Solutions::paint(const double *lp, const int *result, int value) {
   for (int i = 0; i < objective_count; ++i) {
-    r->ip[i] = otherR->ip[i];
+    if (inGrid_[i])
+      continue;
+    if (sense_ == MIN) {
+      if ((lp[i] < gridBase_[i]) || (result && (result[i] > gridBase_[i])))
+        return -1;
+    } else {
+      if ((lp[i] > gridBase_[i]) || (result && (result[i] < gridBase_[i])))
+        return -1;
+    }
   }
-  if (otherR->infeasible) {
-    r->infeasible = true;
-    r->result = nullptr;
-  } else {
-    r->infeasible = false;
-    r->result = new int[objective_count];
-    for (int i = 0; i < objective_count; ++i) {
-      r->result[i] = otherR->result[i];
+  size_t dims = gridDims_.size();
+  std::vector<long> lo(dims), hi(dims);
+  for (size_t d = 0; d < dims; ++d) {
+    int o = gridDims_[d];
+    double l, h;
+    // For a minimisation problem, the relaxation answers every rhs between
+    // its result and its own rhs. Without a result, it answers every rhs
+    // tighter than its own.
+    if (sense_ == MIN) {
+      l = result ? result[o] - gridLower_[d] : 0;
+      h = std::floor(lp[o]) - gridLower_[d];
+    } else {
+      l = std::ceil(lp[o]) - gridLower_[d];
+      h = result ? result[o] - gridLower_[d] : gridExtent_[d] - 1;
+    }
+    if (l < 0)
+      l = 0;
+    if (h > gridExtent_[d] - 1)
+      h = gridExtent_[d] - 1;
+    if (l > h)
+      return 0;
+    lo[d] = static_cast<long>(l);
+    hi[d] = static_cast<long>(h);
+  }
+  long painted = 0;
+  std::vector<long> c(lo);
+  for (;;) {
+    long cell = 0;
+    for (size_t d = 0; d < dims; ++d) {
+      cell = cell * gridExtent_[d] + c[d];
+    }
+    if (grid_[cell] == 0) {
+      grid_[cell] = value;
+      painted++;
+    }
+    size_t d = dims;
+    while (d > 0) {
+      --d;
+      if (c[d] < hi[d]) {
+        c[d]++;
+        break;
+      }
+      c[d] = lo[d];
+      if (d == 0)
+        return painted;
+    }
+  }
+}
+
+/* Add lp to the infeasibility frontier, unless a looser infeasible rhs is
+ * already known. Any rows that lp is a relaxation of are dropped. */
+void Solutions::insertInfeasible(const double *lp) {
+  if (findInfeasible(lp) != nullptr)
+    return;
+  infeasible_.resize(pruneInfeasible_(infeasible_, infeasibleUsed_, lp,
+        objective_count));
+  infeasible_.insert(infeasible_.end(), lp, lp + objective_count);
+  infeasibleUsed_.push_back(++clock_);
+}
+
+/* Drop the least recently used relaxations until we are within our limit,
+ * comparing the oldest feasible result against the oldest infeasible row
+ * each time. If the grid would push us over the limit, it goes first: it
+ * only speeds up lookups, which the list can still answer without it.
+ * Assumes the mutex is held. */
+void Solutions::evict() {
+  if (maxEntries_ == 0)
+    return;
+  if ((! grid_.empty()) && (size() + gridEntries() > maxEntries_))
+    dropGrid();
+  while (size() > maxEntries_) {
+    auto oldest = std::min_element(infeasibleUsed_.begin(),
+        infeasibleUsed_.end());
+    if ((! store_.empty()) && ((oldest == infeasibleUsed_.end()) ||
+          (lastUse(store_.back()) < *oldest))) {
+      release(store_.back());
+      store_.pop_back();
+    } else {
+      size_t row = oldest - infeasibleUsed_.begin();
+      auto first = infeasible_.begin() + row * objective_count;
+      infeasible_.erase(first, first + objective_count);
+      infeasibleUsed_.erase(oldest);
     }
+    cacheevictions++;
   }
-  store_.push_back(r);
 }
 
-Solutions::~Solutions() {
-  for(auto r: store_) {
-    delete[] r->ip;
-    if (r->result)
-      delete[] r->result;
-    delete r;
+/* The grid's share of our limit, counted in entries: its cells, and its
+ * copies of results. */
+size_t Solutions::gridEntries() const {
+  size_t bytes = grid_.size() * sizeof(int);
+  return (bytes + entryBytes(objective_count) - 1) /
+    entryBytes(objective_count) + gridResults_.size();
+}
+
+/* Free the grid and its results. Lookups then scan the list again. */
+void Solutions::dropGrid() {
+  for (Result * r: gridResults_) {
+    release(r);
   }
+  std::vector<Result *>().swap(gridResults_);
+  std::vector<int>().swap(grid_);
+  unpainted_ = 0;
+}
+
+/* A Result, the time it was last used and its two arrays share one slot of
+ * the pool. */
+size_t Solutions::slotBytes(int numObjectives) {
+  size_t head = (sizeof(Result) + alignof(double) - 1) / alignof(double) *
+    alignof(double);
+  return head + sizeof(uint64_t) +
+    numObjectives * (sizeof(double) + sizeof(int));
+}
+
+uint64_t & Solutions::lastUse(Result * r) {
+  return *reinterpret_cast<uint64_t *>(reinterpret_cast<char *>(r) +
+      slotBytes(0) - sizeof(uint64_t));
+}
+
+Result * Solutions::newResult(const double *lp, const int *result) {
+  char * slot = static_cast<char *>(pool_.get());
+  Result * r = new (slot) Result;
+  r->objective_count = objective_count;
+  r->infeasible = false;
+  r->ip = reinterpret_cast<double *>(slot + slotBytes(0));
+  r->result = reinterpret_cast<int *>(r->ip + objective_count);
+  std::copy(lp, lp + objective_count, r->ip);
+  std::copy(result, result + objective_count, r->result);
+  lastUse(r) = ++clock_;
+  return r;
+}
+
+void Solutions::release(Result * r) {
+  pool_.put(r);
 }
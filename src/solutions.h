@@ -14,51 +14,177 @@ You should have received a copy of the GNU General Public License along with thi
 #ifndef SOLUTIONS_H
 #define SOLUTIONS_H
 
+#include <cstddef>
+#include <cstdint>
 #include <list>
 #include <mutex>
+#include <vector>
+#include "arena.h"
+#include "relaxfile.h"
 #include "result.h"
 #include "sense.h"
 
+/**
+ * A store of relaxations, i.e. right-hand sides that have already been solved
+ * along with their results. A store can optionally be capped in size, in
+ * which case the least recently hit relaxations are evicted first.
+ *
+ * All public member functions lock the store, so one store can be shared
+ * between threads. A pointer returned by find() is only valid until the
+ * next insertion into the same store.
+ *
+ * When capped, feasible results and infeasible right-hand sides are evicted
+ * in a single order: whichever was least recently hit or inserted goes first.
+ * The grid (see below) is charged to the same cap, and is dropped as a whole
+ * once the store would otherwise go over it.
+ *
+ * Infeasible right-hand sides are kept apart from the feasible results, as
+ * an "infeasibility frontier": only the loosest infeasible right-hand sides
+ * are stored, since any tighter one is known to be infeasible too. All
+ * infeasible lookups return the same Result, which has no ip or result.
+ *
+ * A store can also be attached to a RelaxationFile, which is then searched
+ * whenever the store itself has no suitable relaxation.
+ *
+ * If every lookup only varies a few objectives over a small integer range
+ * (as inside one P3Task), index() adds a dense grid over those objectives.
+ * Each new relaxation marks every grid cell that it answers, so lookups that
+ * land inside the grid take constant time.
+ *
+ * Every stored result is also a feasible point, so bound() can say how good
+ * the optimum under a rhs must be, even when no relaxation answers it.
+ */
 class Solutions {
 
   public:
-    Solutions(int numObjectives);
-    ~Solutions();
-    const Result * find(const double *ip, const Sense sense) const;
-    void insert(const double *lp, const int *result, const bool infeasible);
-    void insert(const Result *r);
-    void merge(Solutions& other);
+    Solutions(int numObjectives, Sense sense, size_t maxBytes = 0);
+    /**
+     * Find a relaxation of ip. If this store (and its file) has none, but
+     * shared does, that one is copied in and returned.
+     */
+    const Result * find(const double *ip, const Sense sense,
+        Solutions * shared = nullptr);
+    const Result * insert(const double *lp, const int *result,
+        const bool infeasible);
     void sort();
-
-    // Iterator functionality
+    size_t size() const;
+    void attach(const RelaxationFile * file, uint64_t key);
+    bool index(const double * base, const int * dims, const double * lower,
+        const double * upper, int count, size_t maxCells);
+    bool bound(const double * ip, const int * objectives,
+        const double * weights, int count, double & value);
+
+    // Iterator functionality. Note that this only covers feasible results.
     std::list<Result*>::const_iterator begin() const;
     std::list<Result*>::const_iterator end() const;
 
     // Sorting
     static void sort( bool (*cmp)(const Result * a, const Result * b) );
 
+    /**
+     * Approximate number of bytes used by one stored relaxation.
+     */
+    static size_t entryBytes(int numObjectives);
+
   private:
+    const Result * findLocked(const double *ip, const Sense sense,
+        Solutions * shared);
+    const Result * importLocked(Solutions & other, const double *ip);
+    const Result * findFeasible(const double *ip);
+    const double * findInfeasible(const double *ip);
+    const Result * insertLocked(const double *lp, const int *result,
+        const bool infeasible);
+    void insertInfeasible(const double *lp);
+    long gridCell(const double *ip) const;
+    long paint(const double *lp, const int *result, int value);
+    void evict();
+    size_t gridEntries() const;
+    void dropGrid();
+    static size_t slotBytes(int numObjectives);
+    Result * newResult(const double *lp, const int *result);
+    static uint64_t & lastUse(Result * r);
+    void release(Result * r);
+    void specialise();
+
     int objective_count;
-    // Note that a pointer to a Result object should only ever exist in a
-    // single list. We allocate objects inside insert(), and only free them in
-    // the Solutions destructor.
+    Sense sense_;
+    // Scans specialised on objective_count and sense_, see kernels.h.
+    std::list<Result*>::iterator (*scanFeasible_)(std::list<Result*> & store,
+        const double * ip, int count);
+    const double * (*scanInfeasible_)(const std::vector<double> & rows,
+        const double * ip, int count);
+    size_t (*pruneInfeasible_)(std::vector<double> & rows,
+        std::vector<uint64_t> & used, const double * lp, int count);
+    // Maximum number of relaxations to hold, or 0 for no limit.
+    size_t maxEntries_;
+    // Every Result (and its arrays) lives in a slot of pool_, and is only
+    // put back when evicted. A pointer to a Result object should only ever
+    // exist in a single list.
+    Pool pool_;
+    // The list is kept in order of use, with the most recently hit or
+    // inserted relaxation at the front.
     std::list<Result*> store_;
+    // The infeasibility frontier, one right-hand side after another. No row
+    // is ever a relaxation of another row.
+    std::vector<double> infeasible_;
+    // When each row of infeasible_ was last hit or inserted.
+    std::vector<uint64_t> infeasibleUsed_;
+    // Ticks once per hit or insertion, to order feasible results (whose last
+    // use is kept in their slot) against infeasible rows.
+    uint64_t clock_;
+    // Returned for all infeasible lookups.
+    Result infeasibleResult_;
     std::mutex mutex;
+
+    const RelaxationFile * file_;
+    uint64_t key_;
+
+    // The dense grid, if any. Cells hold 0 if nothing is known, -1 if
+    // infeasible, and otherwise one more than an index into gridResults_.
+    std::vector<int> grid_;
+    std::vector<int> gridDims_;
+    std::vector<bool> inGrid_;
+    std::vector<long> gridLower_;
+    std::vector<long> gridExtent_;
+    // Right-hand side of every objective not in the grid. A relaxation that
+    // does not answer these is not marked in the grid.
+    std::vector<double> gridBase_;
+    // The grid keeps its own copies of results, as the list may evict them.
+    std::vector<Result *> gridResults_;
+    // Number of relaxations that could not be marked in the grid. While this
+    // is 0, a grid miss is a miss.
+    size_t unpainted_;
 };
 
-inline Solutions::Solutions(int numObjectives) : objective_count(numObjectives)
-{ }
+inline Solutions::Solutions(int numObjectives, Sense sense, size_t maxBytes) :
+    objective_count(numObjectives), sense_(sense), maxEntries_(0),
+    pool_(slotBytes(numObjectives)), clock_(0), file_(nullptr), key_(0),
+    unpainted_(0) {
+  infeasibleResult_.result = nullptr;
+  infeasibleResult_.objective_count = numObjectives;
+  infeasibleResult_.infeasible = true;
+  infeasibleResult_.ip = nullptr;
+  specialise();
+  if (maxBytes > 0) {
+    maxEntries_ = maxBytes / entryBytes(numObjectives);
+    if (maxEntries_ == 0)
+      maxEntries_ = 1;
+  }
+}
+
+inline size_t Solutions::entryBytes(int numObjectives) {
+  // The pool slot holding the Result and its arrays, and the list node
+  // holding it.
+  return slotBytes(numObjectives) + 3 * sizeof(void *);
+}
 
+inline void Solutions::attach(const RelaxationFile * file, uint64_t key) {
+  file_ = file;
+  key_ = key;
+}
 
-inline void Solutions::merge(Solutions& other) {
-  std::unique_lock<std::mutex> lk(mutex);
-  // Note that only one list is allowed to own a pointer at any one time.
-  // We aren't used unique_ptr to avoid overheads, we are trusting that our
-  // coding is correct.
-  while (other.store_.size() > 0) {
-    store_.push_back(other.store_.front());
-    other.store_.pop_front();
-  }
+inline size_t Solutions::size() const {
+  return store_.size() + infeasible_.size() / objective_count;
 }
 
 inline std::list<Result *>::const_iterator Solutions::begin() const {
@@ -0,0 +1,252 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <sstream>
+
+#include <ilcplex/cplexx.h>
+
+#include "supportedtask.h"
+#include "env.h"
+#include "lexopt.h"
+#include "problem.h"
+
+extern std::atomic<int> ipcount;
+extern std::atomic<bool> interrupted;
+extern std::atomic<long> stoppedEarly;
+extern std::atomic<long> weightedskipped;
+
+#ifdef DEBUG
+extern std::mutex debug_mutex;
+#endif
+
+/* Optimise the weighted sum of i and j that is equal at a and b. If some
+ * point beats a and b, put a nondominated one with the same weighted sum in
+ * result, and return true. Returns false without a solve if the sum could be
+ * too large to solve exactly, which leaves the segment to the walks. */
+bool SupportedTask::weighted(Env & e, Problem & p, const int * a,
+    const int * b, int * result) {
+  int cur_numcols = CPXXgetnumcols(e.env, e.lp);
+  double wi = std::abs(a[j_] - b[j_]);
+  double wj = std::abs(a[i_] - b[i_]);
+  int pair[2] = { i_, j_ };
+  double weights[2] = { wi, wj };
+  if (! p.weighted_sum_fits(pair, weights, 2)) {
+    weightedskipped++;
+    return false;
+  }
+  std::vector<double> coef(cur_numcols);
+  for (int c = 0; c < cur_numcols; ++c) {
+    coef[c] = wi * p.objcoef[i_][c] + wj * p.objcoef[j_][c];
+  }
+  int status = CPXXchgobj(e.env, e.lp, cur_numcols, p.objind[0], coef.data());
+  if (status) {
+    std::cerr << "Failed to set objective." << std::endl;
+  }
+  status = CPXXchgrhs(e.env, e.lp, p.objcnt, p.conind, p.rhs);
+  if (status) {
+    std::cerr << "Failed to change constraint srhs" << std::endl;
+  }
+  // Every weighted value is an integer, so a gap below 1 is exact.
+  CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_MIPGap, 0);
+  CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_AbsMIPGap, 0.5);
+  status = CPXXmipopt(e.env, e.lp);
+  ipcount++;
+  CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_MIPGap, p.mip_tolerance);
+  CPXXsetdblparam(e.env, CPXPARAM_MIP_Tolerances_AbsMIPGap, 1e-6);
+  if (status) {
+    std::cerr << "Failed to optimize LP." << std::endl;
+  }
+  int solnstat = CPXgetstat(e.env, e.lp);
+  if ((solnstat == CPXMIP_INFEASIBLE) || (solnstat == CPXMIP_INForUNBD))
+    return false;
+  double objval;
+  status = CPXXgetobjval(e.env, e.lp, &objval);
+  if ( status ) {
+    std::cerr << "Failed to obtain objective value." << std::endl;
+    exit(0);
+  }
+  double w = round(objval);
+  double ends = wi * a[i_] + wj * a[j_];
+  if ((sense_ == MIN) ? (w > ends - 0.5) : (w < ends + 0.5))
+    return false;
+
+  if (p.objcnt == 2) {
+    soln_.resize(cur_numcols);
+    double * soln = soln_.data();
+    CPXXgetx(e.env, e.lp, soln, 0, cur_numcols - 1);
+    for (int o = 0; o < p.objcnt; o++) {
+      double res = 0;
+      for(int c = 0; c < cur_numcols; ++c) {
+        res += p.objcoef[o][c] * soln[c];
+      }
+      result[o] = round(res);
+    }
+    return true;
+  }
+
+  // Keep the weighted sum at its optimum, and optimise the rest.
+  CPXDIM row = CPXXgetnumrows(e.env, e.lp);
+  char sense[1] = { (sense_ == MIN) ? 'L' : 'G' };
+  CPXNNZ rmatbeg[1] = { 0 };
+  status = CPXXaddrows(e.env, e.lp, 0, 1, cur_numcols, &w, sense, rmatbeg,
+      p.objind[0], coef.data(), NULL, NULL);
+  if (status) {
+    std::cerr << "Failed to add weighted sum." << std::endl;
+    return false;
+  }
+  std::vector<int> order;
+  for (int o = 0; o < p.objcnt; ++o) {
+    if ((o != i_) && (o != j_))
+      order.push_back(o);
+  }
+  order.push_back(i_);
+  order.push_back(j_);
+  solnstat = lexicographicOptimum(e, p, order.data(), p.objcnt, p.rhs, result,
+      srhs_, soln_);
+  CPXXdelrows(e.env, e.lp, row, row);
+  return (solnstat != CPXMIP_INFEASIBLE) && (solnstat != CPXMIP_INForUNBD);
+}
+
+void SupportedTask::keep(const int * result) {
+  int * n = newSolution();
+  for (int o = 0; o < objCountTotal_; ++o) {
+    n[o] = result[o];
+  }
+}
+
+/* Hand the segment from a to b to a new task, which finishes before any of
+ * ours do. */
+void SupportedTask::split(const int * a, const int * b) {
+  SupportedTask * t = new SupportedTask(filename_, objCountTotal_, sense_,
+      i_, j_, taskServer_, a, b);
+  for (auto n: nextLevel_) {
+    n->addPreReq(t);
+    t->addNextLevel(n);
+  }
+  taskServer_->q(t);
+}
+
+Status SupportedTask::operator()() {
+  status_ = RUNNING;
+  if (interrupted) {
+    stoppedEarly++;
+    done();
+    return status_;
+  }
+#ifdef DEBUG
+  debug_mutex.lock();
+  std::cout << details();
+  debug_mutex.unlock();
+#endif
+  Env e;
+
+  int status;
+  /* Initialize the CPLEX environment */
+  e.env = CPXopenCPLEX (&status);
+  if (status != 0) {
+    std::cerr << "Could not open CPLEX environment." << std::endl;
+  }
+
+  /* Set to deterministic parallel mode */
+  status = CPXsetintparam(e.env, CPXPARAM_Parallel, CPX_PARALLEL_DETERMINISTIC);
+
+  /* Set to only one thread */
+  CPXsetintparam(e.env, CPXPARAM_Threads, 1);
+
+  if (e.env == NULL) {
+    std::cerr << "Could not open CPLEX environment." << std::endl;
+  }
+
+  status = CPXsetintparam(e.env, CPX_PARAM_SCRIND, CPX_OFF);
+  if (status) {
+    std::cerr << "Failure to turn off screen indicator." << std::endl;
+  }
+
+  Problem p(filename_.c_str(), e);
+  std::vector<int> a(p.objcnt), b(p.objcnt), c(p.objcnt);
+  bool found = true;
+
+  if (root_) {
+    // The ends of our projection: the lexicographic optima that put i and
+    // then j first.
+    std::vector<int> order;
+    order.push_back(i_);
+    order.push_back(j_);
+    for (int o = 0; o < p.objcnt; ++o) {
+      if ((o != i_) && (o != j_))
+        order.push_back(o);
+    }
+    int solnstat = lexicographicOptimum(e, p, order.data(), p.objcnt, p.rhs,
+        a.data(), srhs_, soln_);
+    found = (solnstat != CPXMIP_INFEASIBLE) && (solnstat != CPXMIP_INForUNBD);
+    if (found) {
+      std::swap(order[0], order[1]);
+      lexicographicOptimum(e, p, order.data(), p.objcnt, p.rhs, b.data(),
+          srhs_, soln_);
+      keep(a.data());
+      if (b != a)
+        keep(b.data());
+    }
+    // Without integral objectives the weighted sums are not exact, so only
+    // the ends are certain.
+    found = found && p.objintegral[i_] && p.objintegral[j_];
+  } else {
+    a.assign(a_.begin(), a_.end());
+    b.assign(b_.begin(), b_.end());
+  }
+
+  if (found && (a[i_] != b[i_]) && (a[j_] != b[j_]) &&
+      weighted(e, p, a.data(), b.data(), c.data())) {
+    keep(c.data());
+#ifdef DEBUG
+    debug_mutex.lock();
+    std::cout << str() << " found [" << c[0];
+    for (int o = 1; o < p.objcnt; ++o) {
+      std::cout << ", " << c[o];
+    }
+    std::cout << "]" << std::endl;
+    debug_mutex.unlock();
+#endif
+    CPXfreeprob(e.env, &e.lp);
+    CPXcloseCPLEX(&e.env);
+    split(a.data(), c.data());
+    split(c.data(), b.data());
+  } else {
+    CPXfreeprob(e.env, &e.lp);
+    CPXcloseCPLEX(&e.env);
+  }
+
+  done();
+  return status_;
+}
+
+std::string SupportedTask::str() const {
+  std::stringstream ss;
+  ss << "SupportedTask: objectives " << i_ << " and " << j_;
+  if (! root_) {
+    ss << " between [" << a_[i_] << ", " << a_[j_] << "] and [";
+    ss << b_[i_] << ", " << b_[j_] << "]";
+  }
+  return ss.str();
+}
+
+std::string SupportedTask::details() const {
+  std::stringstream ss;
+  ss << str() << " is " << status_ << std::endl;
+  return ss.str();
+}
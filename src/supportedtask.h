@@ -0,0 +1,102 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef SUPPORTEDTASK_H
+#define SUPPORTEDTASK_H
+
+#ifdef DEBUG
+#include <mutex>
+#endif
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "task.h"
+#include "env.h"
+#include "jobserver.h"
+#include "problem.h"
+
+/**
+ * Part of a dichotomic search for the extreme supported points of the
+ * projection of the front onto two objectives, i and j.
+ *
+ * A task holds two supported points a and b, where a is the better on i and
+ * b the better on j, and minimises the weighted sum of i and j whose level
+ * sets run through both. If some point beats them, it is a new extreme
+ * supported point c, and the segments from a to c and from c to b become new
+ * tasks. The first task of each pair finds the two ends of its projection
+ * instead.
+ *
+ * With more than two objectives, the weighted optimum is made nondominated
+ * by then optimising the other objectives while keeping the weighted sum at
+ * its optimum.
+ */
+class SupportedTask : public Task {
+  public:
+    SupportedTask(std::string & filename, int objCountTotal, Sense sense,
+        int i, int j, JobServer * taskServer);
+    SupportedTask(std::string & filename, int objCountTotal, Sense sense,
+        int i, int j, JobServer * taskServer, const int * a, const int * b);
+    Status operator()();
+
+    void addNextLevel(Task * nextLevel);
+
+    virtual std::string str() const;
+    virtual std::string details() const;
+    virtual bool certified() const;
+  private:
+    bool weighted(Env & e, Problem & p, const int * a, const int * b,
+        int * result);
+    void split(const int * a, const int * b);
+    void keep(const int * result);
+
+    JobServer * taskServer_;
+    std::list<Task *> nextLevel_;
+    // Our pair of objectives.
+    int i_;
+    int j_;
+    // Our ends, unless we are the first task of our pair.
+    bool root_;
+    std::vector<int> a_;
+    std::vector<int> b_;
+    // Scratch space for lexicographicOptimum().
+    std::vector<double> srhs_;
+    std::vector<double> soln_;
+};
+
+inline SupportedTask::SupportedTask(std::string & filename, int objCountTotal,
+    Sense sense, int i, int j, JobServer * taskServer) :
+    Task(filename, 2, objCountTotal, std::vector<int>({i, j}).data(), sense),
+    taskServer_(taskServer), i_(i), j_(j), root_(true) {
+}
+
+inline SupportedTask::SupportedTask(std::string & filename, int objCountTotal,
+    Sense sense, int i, int j, JobServer * taskServer, const int * a,
+    const int * b) :
+    Task(filename, 2, objCountTotal, std::vector<int>({i, j}).data(), sense),
+    taskServer_(taskServer), i_(i), j_(j), root_(false),
+    a_(a, a + objCountTotal), b_(b, b + objCountTotal) {
+}
+
+inline void SupportedTask::addNextLevel(Task * nextLevel) {
+  nextLevel_.push_back(nextLevel);
+}
+
+/* Every point is optimal for a weighted sum with positive weights, or
+ * lexicographically optimal, so nothing can dominate it. */
+inline bool SupportedTask::certified() const {
+  return true;
+}
+
+#endif /* SUPPORTEDTASK_H */
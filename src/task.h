@@ -19,8 +19,15 @@ You should have received a copy of the GNU General Public License along with thi
 #include <mutex>
 #include <string>
 #include <iostream>
+#include <memory>
+#include <vector>
 
+#include "arena.h"
+#include "pareto.h"
+#include "paretoarchive.h"
+#include "radixsort.h"
 #include "sense.h"
+#include "solutionblock.h"
 
 #ifdef DEBUG
 extern std::mutex debug_mutex;
@@ -44,8 +51,8 @@ class Task {
     bool isReady() const;
     Status status() const;
     void dumpSolutions(std::ostream & out) const;
-    void cleanSolutions();
-    void removeNonPareto();
+    void cleanSolutions(int threads = 1);
+    void removeNonPareto(int threads = 1);
     int objCount() const;
     int objective(int i) const;
 
@@ -53,20 +60,42 @@ class Task {
 
     virtual Status operator()() = 0;
 
-    const std::list<int *> solutions() const;
+    const std::vector<const int *> & solutions() const;
+    std::shared_ptr<const SolutionBlock> take();
 
     virtual std::string str() const = 0;
     virtual std::string details() const = 0;
 
+    /**
+     * True if every solution this task finds is known to be nondominated
+     * over the whole problem, not just over the objectives it compares.
+     */
+    virtual bool certified() const;
+
   protected:
     void gatherSolutions();
+    virtual void receive(std::shared_ptr<const SolutionBlock> b,
+        bool certified);
+    int * newSolution();
+    void done();
     void sortSolutions();
     void removeDuplicates();
     Status status_;
     std::mutex listMutex_;
     std::list<Task *> preReqs_;
 
-    std::list<int*> solutions_;
+    // The solutions of this task. These point either into owned_, or into
+    // one of the blocks in sources_.
+    std::vector<const int *> solutions_;
+    Arena owned_;
+    std::vector<std::shared_ptr<const SolutionBlock>> sources_;
+    // Made by done(), and held until every consumer has taken it.
+    std::shared_ptr<const SolutionBlock> block_;
+    int consumers_;
+    std::list<Task *> consumerTasks_;
+    // If set, solutions are streamed into this archive as each
+    // pre-requisite finishes, instead of being gathered at the start.
+    ParetoArchive * archive_;
     std::string filename_;
     int objCount_;
     int objCountTotal_;
@@ -78,8 +107,9 @@ class Task {
 std::ostream & operator<<(std::ostream & str, const Task & t);
 
 inline Task::Task(std::string filename, int objCount, int objCountTotal,
-    int * objectives, Sense sense) : filename_(filename),
-    objCount_(objCount), objCountTotal_(objCountTotal), sense_(sense) {
+    int * objectives, Sense sense) : consumers_(0), archive_(nullptr),
+    filename_(filename), objCount_(objCount), objCountTotal_(objCountTotal),
+    sense_(sense) {
   objectives_ = new int[objCount_];
   status_ = WAITING;
   for (int i = 0; i < objCount_; ++i) {
@@ -89,14 +119,17 @@ inline Task::Task(std::string filename, int objCount, int objCountTotal,
 
 inline Task::~Task() {
   delete[] objectives_;
-  for(int * s: solutions_) {
-    delete[] s;
-  }
+  delete archive_;
 }
 
 inline void Task::addPreReq(Task * t) {
-  std::unique_lock<std::mutex> lock(listMutex_);
-  preReqs_.push_back(t);
+  {
+    std::unique_lock<std::mutex> lock(listMutex_);
+    preReqs_.push_back(t);
+  }
+  std::unique_lock<std::mutex> lock(t->listMutex_);
+  t->consumers_++;
+  t->consumerTasks_.push_back(this);
 }
 
 inline Status Task::status() const {
@@ -135,84 +168,141 @@ inline int Task::objective(int i) const {
   return objectives_[i];
 }
 
+/* Collect the solutions of every pre-requisite. Only pointers are copied:
+ * the solutions themselves stay in the blocks they came from. If we have an
+ * archive, our pre-requisites have already streamed everything into it, and
+ * our solutions are the archive's copies. The memory holding those goes into
+ * a block of its own, so that it lives as long as our solutions do. */
 inline void Task::gatherSolutions() {
+  if (archive_ != nullptr) {
+    solutions_ = archive_->solutions();
+    sources_.push_back(std::make_shared<const SolutionBlock>(
+          archive_->release(),
+          std::vector<std::shared_ptr<const SolutionBlock>>(),
+          std::vector<const int *>()));
+    return;
+  }
   for(auto t: preReqs_) {
-    for(int * s: t->solutions()) {
-      int * n = new int[objCountTotal_];
-      for(int i = 0; i < objCountTotal_; ++i) {
-        n[i] = s[i];
-      }
-      solutions_.push_back(n);
-    }
+    std::shared_ptr<const SolutionBlock> b = t->take();
+    if (! b)
+      continue;
+    solutions_.insert(solutions_.end(), b->solutions().begin(),
+        b->solutions().end());
+    sources_.push_back(b);
+  }
+}
+
+inline bool Task::certified() const {
+  return false;
+}
+
+/* Called by a pre-requisite as it finishes, if we have an archive. The
+ * archive copies what it keeps, so we let go of the block straight away. */
+inline void Task::receive(std::shared_ptr<const SolutionBlock> b, bool) {
+  if (! b)
+    return;
+  archive_->insert(b->solutions());
+}
+
+/* Add a solution found by this task, to be filled in by the caller. */
+inline int * Task::newSolution() {
+  int * s = owned_.alloc<int>(objCountTotal_);
+  solutions_.push_back(s);
+  return s;
+}
+
+/* Hand our solutions over to a block for our consumers, and mark this task
+ * as done. */
+inline void Task::done() {
+  block_ = std::make_shared<const SolutionBlock>(std::move(owned_),
+      std::move(sources_), solutions_);
+  sources_.clear();
+  // Consumers with an archive get our solutions now, rather than when they
+  // start.
+  std::list<Task *> consumers;
+  {
+    std::unique_lock<std::mutex> lock(listMutex_);
+    consumers = consumerTasks_;
+  }
+  for(auto c: consumers) {
+    if (c->archive_ != nullptr)
+      c->receive(take(), certified());
+  }
+  status_ = DONE;
+}
+
+/* Called once by each consumer of this task. Once the last consumer has
+ * taken our block, we drop our own reference to it, so the consumers alone
+ * decide how long these solutions live. */
+inline std::shared_ptr<const SolutionBlock> Task::take() {
+  std::unique_lock<std::mutex> lock(listMutex_);
+  std::shared_ptr<const SolutionBlock> b = block_;
+  if (--consumers_ <= 0) {
+    block_.reset();
+    solutions_.clear();
+    solutions_.shrink_to_fit();
   }
+  return b;
 }
 
-inline void Task::cleanSolutions() {
-  sortSolutions();
-  removeDuplicates();
-  removeNonPareto();
+inline void Task::cleanSolutions(int threads) {
+  if (! radixSortUnique(solutions_, objCount_)) {
+    sortSolutions();
+    removeDuplicates();
+  }
+  removeNonPareto(threads);
 }
 
 inline void Task::sortSolutions() {
-//  std::sort(solutions_.begin(), solutions_.end(),
-  solutions_.sort(
-      [this](int * a, int * b) {
+  // Solutions that tie on the compared objectives keep their order.
+  std::stable_sort(solutions_.begin(), solutions_.end(),
+      [this](const int * a, const int * b) {
         for(int i = 0; i < this->objCount_; ++i) {
           if (a[i] < b[i])
             return false;
           if (a[i] > b[i])
             return true;
         }
-        return true;
+        return false;
       });
 }
 
+/* Drop all but the first of each run of solutions that agree on the
+ * compared objectives. Assumes the solutions are sorted. */
 inline void Task::removeDuplicates() {
-  solutions_.erase( std::unique(solutions_.begin(), solutions_.end(),
-        [this](int * a, int * b) {
-        for(int i = 0; i < this->objCount_; ++i) {
-          if (a[i] != b[i])
-            return false;
-        }
-        return true;
-      }), solutions_.end());
-}
-
-inline void Task::removeNonPareto() {
-  solutions_.erase( std::remove_if(solutions_.begin(), solutions_.end(),
-        [this](int * a) {
-        for(int * b: solutions_) {
-          bool notWorse = true;
-          bool better = false;
-          for(int i = 0; i < this->objCount_ && notWorse; ++i) {
-            if ((sense_ == MIN) && (a[i] < b[i]))
-              notWorse = false;
-            if ((sense_ == MIN) && (a[i] > b[i]))
-              better = true;
-            if ((sense_ == MAX) && (a[i] > b[i]))
-              notWorse = false;
-            if ((sense_ == MAX) && (a[i] < b[i]))
-              better = true;
-          }
-          if (notWorse && better) {
-            return true;
-          }
-        }
-        return false;
-      }), solutions_.end());
+  size_t keep = 0;
+  for (size_t i = 0; i < solutions_.size(); ++i) {
+    const int * s = solutions_[i];
+    if ((keep == 0) || ! std::equal(s, s + objCount_, solutions_[keep - 1])) {
+      solutions_[keep++] = s;
+    }
+  }
+  solutions_.resize(keep);
+}
+
+inline void Task::removeNonPareto(int threads) {
+  std::vector<char> dominated = findDominated(solutions_, objCount_, sense_,
+      threads);
+  size_t keep = 0;
+  for (size_t i = 0; i < solutions_.size(); ++i) {
+    if (! dominated[i]) {
+      solutions_[keep++] = solutions_[i];
+    }
+  }
+  solutions_.resize(keep);
 }
 
 inline void Task::dumpSolutions(std::ostream & out) const {
-  for (int * s: solutions()) {
+  for (const int * s: solutions()) {
     out << s[0];
     for (int i  = 1; i < objCountTotal_; ++i) {
       out << "\t" << s[i];
     }
-    out << std::endl;
+    out << '\n';
   }
 }
 
-const inline std::list<int *> Task::solutions() const {
+inline const std::vector<const int *> & Task::solutions() const {
   return solutions_;
 }
 
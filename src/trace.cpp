@@ -0,0 +1,125 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+
+#include "trace.h"
+
+extern std::atomic<int> ipcount;
+
+static const double REFRESH_SECONDS = 1;
+
+static double now() {
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec/1e9;
+}
+
+Trace::Trace(const std::string & filename, int objcnt, Sense sense) :
+    objcnt_(objcnt), sense_(sense), start_(now()), out_(filename),
+    hv_(nullptr), lastRefresh_(start_), refreshCost_(0) {
+  if (! out_) {
+    std::cerr << "Warning: Could not open trace file " << filename;
+    std::cerr << ", not tracing." << std::endl;
+    return;
+  }
+  out_ << "# seconds\tIPs\thypervolume\tfraction" << '\n';
+}
+
+Trace::~Trace() {
+  delete hv_;
+}
+
+void Trace::setBounds(const int * objectives, const double * lower,
+    const double * upper) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (hv_ != nullptr)
+    return;
+  // The ideal corner is the best value of each objective, and the
+  // reference point is one step past the worst, so that solutions on the
+  // far side of the box still count.
+  std::vector<double> ideal(objcnt_), reference(objcnt_);
+  for (int i = 0; i < objcnt_; ++i) {
+    int o = objectives[i];
+    ideal[o] = (sense_ == MIN) ? lower[i] : upper[i];
+    reference[o] = (sense_ == MIN) ? upper[i] + 1 : lower[i] - 1;
+  }
+  hv_ = new Hypervolume(objcnt_, sense_, ideal.data(), reference.data());
+  for (size_t s = 0; s < early_.size(); s += objcnt_) {
+    hv_->add(&early_[s]);
+  }
+  early_.clear();
+  early_.shrink_to_fit();
+  refresh(true);
+  writeLine();
+}
+
+void Trace::insert(const int * s) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (hv_ == nullptr) {
+    early_.insert(early_.end(), s, s + objcnt_);
+    return;
+  }
+  if (hv_->add(s) > 0)
+    writeLine();
+  else
+    refresh(false);
+}
+
+void Trace::walkOrder(const int * objectives, int count) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  out_ << "# walk order";
+  for (int i = 0; i < count; ++i) {
+    out_ << " " << objectives[i];
+  }
+  out_ << '\n';
+}
+
+void Trace::finish() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (hv_ != nullptr) {
+    refresh(true);
+    writeLine();
+  }
+  out_.flush();
+}
+
+/* Bring a stale hypervolume up to date, and write a line if it grew. Unless
+ * forced, wait REFRESH_SECONDS, and ten times as long as the last refresh
+ * took, since the last one. The caller writes its own line if forced. */
+void Trace::refresh(bool force) {
+  if (! hv_->stale())
+    return;
+  double t = now();
+  if ((! force) &&
+      (t - lastRefresh_ < std::max(REFRESH_SECONDS, 10 * refreshCost_)))
+    return;
+  double gain = hv_->refresh();
+  lastRefresh_ = now();
+  refreshCost_ = lastRefresh_ - t;
+  if ((! force) && (gain > 0))
+    writeLine();
+}
+
+void Trace::writeLine() {
+  double fraction = (hv_->boxVolume() > 0) ?
+    hv_->value() / hv_->boxVolume() : 0;
+  out_ << std::fixed << std::setprecision(3) << now() - start_ << "\t";
+  out_ << ipcount << "\t";
+  out_ << std::defaultfloat << std::setprecision(12) << hv_->value() << "\t";
+  out_ << std::setprecision(6) << fraction << '\n';
+}
@@ -0,0 +1,87 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "hypervolume.h"
+#include "sense.h"
+
+/**
+ * A record of how quickly the front converges, written to a file.
+ *
+ * Each time a solution enters the final result set, and adds to the
+ * hypervolume, one line is written: the elapsed time, the number of IPs
+ * solved so far, the hypervolume, and the hypervolume as a fraction of the
+ * whole box. The box is the one that the last P3Creator searches, which
+ * bounds the front, and is only known once that P3Creator exists. Solutions
+ * that arrive before then are held back until it is known.
+ *
+ * With three objectives, the hypervolume is only recomputed (by
+ * Hypervolume::refresh()) once every REFRESH_SECONDS, and never more often
+ * than keeps these refreshes under a tenth of the time between them. Lines
+ * then come at most that often.
+ */
+class Trace {
+  public:
+    Trace(const std::string & filename, int objcnt, Sense sense);
+    ~Trace();
+
+    bool valid() const;
+
+    /**
+     * Set the box from the bounds that a P3Creator was given, with one
+     * value per objective in the order given by objectives.
+     */
+    void setBounds(const int * objectives, const double * lower,
+        const double * upper);
+
+    void insert(const int * s);
+
+    /**
+     * Note the order that a P3Creator gave its P3Tasks, as a comment line.
+     */
+    void walkOrder(const int * objectives, int count);
+
+    /**
+     * Write a final line, whether or not the hypervolume changed.
+     */
+    void finish();
+
+  private:
+    void refresh(bool force);
+    void writeLine();
+
+    int objcnt_;
+    Sense sense_;
+    double start_;
+    std::ofstream out_;
+    std::mutex mutex_;
+    Hypervolume * hv_;
+    // When the last refresh finished, and how long it took.
+    double lastRefresh_;
+    double refreshCost_;
+    // Solutions that arrived before the box was known.
+    std::vector<int> early_;
+};
+
+inline bool Trace::valid() const {
+  return out_.good();
+}
+
+#endif /* TRACE_H */
@@ -0,0 +1,133 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef WITNESSES_H
+#define WITNESSES_H
+
+#include <utility>
+#include <vector>
+
+#include "kernels.h"
+#include "sense.h"
+
+/**
+ * Feasible solutions that a P3Task has seen along the way, such as the
+ * other incumbents that CPLEX found before reaching an optimum. They are not
+ * known to be optimal under any rhs, so they cannot stand in for
+ * relaxations, but one that satisfies a rhs is a feasible start for the IP
+ * under that rhs.
+ *
+ * Each witness holds the values of every objective and the solution vector.
+ * Witnesses that another one dominates are dropped, as the other is a
+ * better start wherever they are feasible, and at most capacity are kept.
+ */
+class Witnesses {
+  public:
+    Witnesses(int objcnt, Sense sense, size_t capacity = 256);
+
+    /**
+     * Add a witness, unless one we have is at least as good. Returns true if
+     * it was added.
+     */
+    bool insert(const int * values, const double * x, int numcols);
+
+    /**
+     * The solution vector of the lexicographically best witness (over the
+     * given objectives, in order) that satisfies rhs, or nullptr if none
+     * does.
+     */
+    const double * find(const double * rhs, const int * objectives,
+        int count) const;
+
+    size_t size() const;
+
+  private:
+    struct Witness {
+      std::vector<int> values;
+      std::vector<double> x;
+    };
+
+    bool better(const int * a, const int * b, const int * objectives,
+        int count) const;
+
+    int objcnt_;
+    Sense sense_;
+    size_t capacity_;
+    std::vector<Witness> witnesses_;
+};
+
+inline Witnesses::Witnesses(int objcnt, Sense sense, size_t capacity) :
+    objcnt_(objcnt), sense_(sense), capacity_(capacity) {
+}
+
+inline bool Witnesses::insert(const int * values, const double * x,
+    int numcols) {
+  size_t keep = 0;
+  for (size_t i = 0; i < witnesses_.size(); ++i) {
+    const int * w = witnesses_[i].values.data();
+    bool covers = (sense_ == MIN) ?
+      weaklyDominates<0, MIN>(w, values, objcnt_) :
+      weaklyDominates<0, MAX>(w, values, objcnt_);
+    if (covers)
+      return false;
+  }
+  for (size_t i = 0; i < witnesses_.size(); ++i) {
+    const int * w = witnesses_[i].values.data();
+    bool dominated = (sense_ == MIN) ?
+      dominates<0, MIN>(values, w, objcnt_) :
+      dominates<0, MAX>(values, w, objcnt_);
+    if (dominated)
+      continue;
+    if (keep != i)
+      std::swap(witnesses_[keep], witnesses_[i]);
+    keep++;
+  }
+  witnesses_.resize(keep);
+  if (witnesses_.size() >= capacity_)
+    return false;
+  witnesses_.push_back(Witness());
+  witnesses_.back().values.assign(values, values + objcnt_);
+  witnesses_.back().x.assign(x, x + numcols);
+  return true;
+}
+
+inline const double * Witnesses::find(const double * rhs,
+    const int * objectives, int count) const {
+  const Witness * best = nullptr;
+  for (const Witness & w: witnesses_) {
+    bool feasible = (sense_ == MIN) ?
+      satisfies<0, MIN>(w.values.data(), rhs, objcnt_) :
+      satisfies<0, MAX>(w.values.data(), rhs, objcnt_);
+    if (feasible && ((best == nullptr) ||
+          better(w.values.data(), best->values.data(), objectives, count)))
+      best = &w;
+  }
+  return (best == nullptr) ? nullptr : best->x.data();
+}
+
+/* Is a lexicographically better than b over the given objectives? */
+inline bool Witnesses::better(const int * a, const int * b,
+    const int * objectives, int count) const {
+  for (int i = 0; i < count; ++i) {
+    int o = objectives[i];
+    if (a[o] != b[o])
+      return (sense_ == MIN) ? (a[o] < b[o]) : (a[o] > b[o]);
+  }
+  return false;
+}
+
+inline size_t Witnesses::size() const {
+  return witnesses_.size();
+}
+
+#endif /* WITNESSES_H */
@@ -0,0 +1,144 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+/*
+ * Counts the heap allocations made by the hot paths that use arena.h:
+ *  - a store of relaxations, uncapped, capped and with a dense grid, and
+ *  - a task handing 20000 solutions to a consumer.
+ * The counting operator new is the same hook that main.cpp installs with
+ * -DCOUNT_ALLOCATIONS.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+
+#include "solutions.h"
+#include "task.h"
+
+std::atomic<long> allocations(0);
+
+void * operator new(std::size_t size) {
+  allocations++;
+  void * p = std::malloc(size ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void * p) noexcept {
+  std::free(p);
+}
+
+/* A task whose solutions are added from outside, and which hands them on
+ * when run. */
+class PointTask : public Task {
+  public:
+    PointTask(int * objectives);
+    Status operator()();
+    std::string str() const;
+    std::string details() const;
+    void add(int value);
+};
+
+PointTask::PointTask(int * objectives) : Task("", 3, 3, objectives, MIN) {
+}
+
+Status PointTask::operator()() {
+  gatherSolutions();
+  done();
+  return status_;
+}
+
+std::string PointTask::str() const {
+  return "PointTask";
+}
+
+std::string PointTask::details() const {
+  return "";
+}
+
+void PointTask::add(int value) {
+  int * s = newSolution();
+  s[0] = value;
+  s[1] = -value;
+  s[2] = value % 7;
+}
+
+/* Look up 20000 random right-hand sides, inserting a relaxation on every
+ * miss. */
+static void fill(Solutions & store, std::mt19937 & gen, int range) {
+  double ip[3];
+  int result[3];
+  for (int i = 0; i < 20000; ++i) {
+    ip[0] = 1e20;
+    result[0] = 0;
+    for (int j = 1; j < 3; ++j) {
+      ip[j] = gen() % range;
+      result[j] = ip[j] - gen() % 5;
+    }
+    if (store.find(ip, MIN) == nullptr)
+      store.insert(ip, result, gen() % 500 == 0);
+  }
+}
+
+int main() {
+  std::mt19937 gen(3);
+  long base = allocations;
+  {
+    Solutions store(3, MIN);
+    fill(store, gen, 100000);
+  }
+  std::cout << "Solutions: " << allocations - base << " allocations";
+  std::cout << std::endl;
+
+  base = allocations;
+  {
+    Solutions store(3, MIN, 20000);
+    fill(store, gen, 100000);
+  }
+  std::cout << "Solutions, capped at 20000 bytes: " << allocations - base;
+  std::cout << " allocations" << std::endl;
+
+  base = allocations;
+  {
+    Solutions store(3, MIN);
+    double rhs[] = { 1e20, 0, 0 };
+    int dims[] = { 1, 2 };
+    double lower[] = { 0, 0 };
+    double upper[] = { 99, 99 };
+    store.index(rhs, dims, lower, upper, 2, 1 << 18);
+    fill(store, gen, 100);
+  }
+  std::cout << "Solutions with a grid: " << allocations - base;
+  std::cout << " allocations" << std::endl;
+
+  base = allocations;
+  {
+    int objectives[] = { 0, 1, 2 };
+    PointTask producer(objectives);
+    PointTask consumer(objectives);
+    consumer.addPreReq(&producer);
+    for (int i = 0; i < 20000; ++i) {
+      producer.add(i);
+    }
+    producer();
+    consumer();
+  }
+  std::cout << "Task with 20000 solutions, handed on: ";
+  std::cout << allocations - base << " allocations" << std::endl;
+  return 0;
+}
@@ -0,0 +1,147 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+/*
+ * Times the loops specialised in kernels.h on random data, for two to four
+ * objectives:
+ *  - Solutions::find() over 4000 stored relaxations,
+ *  - Task::removeNonPareto() on 3000 points, and
+ *  - BoxStore::find() over 2000 boxes.
+ * The data comes from a fixed seed, so runs of different builds can be
+ * compared directly. Build with optimisation, e.g. "make -C tests bench".
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "box.h"
+#include "boxstore.h"
+#include "solutions.h"
+#include "task.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/* A task that does nothing but hold solutions. */
+class PointTask : public Task {
+  public:
+    PointTask(int k, int * objectives);
+    Status operator()();
+    std::string str() const;
+    std::string details() const;
+    void add(const int * values);
+    size_t size() const;
+};
+
+PointTask::PointTask(int k, int * objectives) :
+    Task("", k, k, objectives, MIN) {
+}
+
+Status PointTask::operator()() {
+  return DONE;
+}
+
+std::string PointTask::str() const {
+  return "PointTask";
+}
+
+std::string PointTask::details() const {
+  return "";
+}
+
+void PointTask::add(const int * values) {
+  int * s = newSolution();
+  std::copy(values, values + objCount_, s);
+}
+
+size_t PointTask::size() const {
+  return solutions_.size();
+}
+
+static double since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main() {
+  const int queries = 20000;
+  std::mt19937 gen(7);
+  int objectives[] = { 0, 1, 2, 3 };
+  for (int k = 2; k <= 4; ++k) {
+    double ip[4];
+    int result[4];
+
+    Solutions store(k, MIN);
+    for (int i = 0; i < 4000; ++i) {
+      for (int j = 0; j < k; ++j) {
+        ip[j] = 1000 + gen() % 1000;
+        result[j] = ip[j] - gen() % 2000;
+      }
+      ip[0] = 1e20;
+      store.insert(ip, result, false);
+    }
+    long hits = 0;
+    Clock::time_point start = Clock::now();
+    for (int q = 0; q < queries; ++q) {
+      for (int j = 0; j < k; ++j) {
+        ip[j] = static_cast<double>(gen() % 3000) - 1000;
+      }
+      ip[0] = 1e20;
+      if (store.find(ip, MIN) != nullptr)
+        hits++;
+    }
+    double findTime = since(start);
+
+    PointTask task(k, objectives);
+    for (int i = 0; i < 3000; ++i) {
+      for (int j = 0; j < k; ++j) {
+        result[j] = gen() % 10000;
+      }
+      task.add(result);
+    }
+    start = Clock::now();
+    task.removeNonPareto();
+    double paretoTime = since(start);
+
+    BoxStore boxes(k);
+    double lower[4], upper[4];
+    for (int i = 0; i < 2000; ++i) {
+      for (int j = 0; j < k; ++j) {
+        lower[j] = gen() % 1000;
+        upper[j] = lower[j] + gen() % 100;
+      }
+      boxes.insert(new Box(upper, lower, objectives, k));
+    }
+    long found = 0;
+    int point[4];
+    start = Clock::now();
+    for (int q = 0; q < queries; ++q) {
+      for (int j = 0; j < k; ++j) {
+        point[j] = gen() % 1100;
+      }
+      if (boxes.find(point) != nullptr)
+        found++;
+    }
+    double boxTime = since(start);
+
+    std::cout << "k=" << k;
+    std::cout << "  Solutions::find " << findTime * 1e6 / queries;
+    std::cout << " us/query (" << hits << " hits)";
+    std::cout << "  removeNonPareto " << paretoTime * 1e3;
+    std::cout << " ms (" << task.size() << " kept)";
+    std::cout << "  BoxStore::find " << boxTime * 1e6 / queries;
+    std::cout << " us/query (" << found << " found)" << std::endl;
+  }
+  return 0;
+}
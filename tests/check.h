@@ -0,0 +1,38 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <iostream>
+
+/*
+ * A minimal check for the unit tests: report a failed condition with its
+ * location, and count it. Each test's main() returns checkFailures() != 0.
+ */
+
+inline int & checkFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(cond) \
+  do { \
+    if (! (cond)) { \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond \
+        ") failed" << std::endl; \
+      checkFailures()++; \
+    } \
+  } while (0)
+
+#endif /* CHECK_H */
@@ -0,0 +1,30 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+/*
+ * The counters that main.cpp defines for --stats, so that the unit tests and
+ * benchmarks can link the modules that update them without main.cpp (and
+ * without CPLEX).
+ */
+
+#include <atomic>
+#include <mutex>
+
+std::atomic<long> cachehits(0);
+std::atomic<long> cachemisses(0);
+std::atomic<long> cacheevictions(0);
+std::atomic<long> diskhits(0);
+
+#ifdef DEBUG
+std::mutex debug_mutex;
+#endif
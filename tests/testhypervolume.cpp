@@ -0,0 +1,121 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+/*
+ * Checks Staircase and Hypervolume against a count of the unit cells that a
+ * set of integer points dominates. Two and three objectives must be exact,
+ * more objectives within a few percent of the box.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "hypervolume.h"
+
+/* The number of unit cells in [ideal, ref) dominated by some point, in
+ * minimisation terms. */
+static double cells(const std::vector<std::vector<int>> & points,
+    const std::vector<int> & ideal, const std::vector<int> & ref) {
+  int k = ideal.size();
+  std::vector<int> c(ideal);
+  double count = 0;
+  while (true) {
+    for (const std::vector<int> & p : points) {
+      bool dominated = true;
+      for (int i = 0; i < k; ++i) {
+        dominated = dominated && (p[i] <= c[i]);
+      }
+      if (dominated) {
+        count++;
+        break;
+      }
+    }
+    int i = k - 1;
+    while ((i >= 0) && (++c[i] == ref[i])) {
+      c[i] = ideal[i];
+      --i;
+    }
+    if (i < 0)
+      return count;
+  }
+}
+
+int main() {
+  std::mt19937 gen(11);
+
+  // The staircase on its own.
+  for (int trial = 0; trial < 500; ++trial) {
+    Staircase stair(20, 20);
+    std::vector<std::vector<int>> points;
+    double sum = 0;
+    for (int n = 1 + gen() % 30; n > 0; --n) {
+      std::vector<int> p = { static_cast<int>(gen() % 22),
+        static_cast<int>(gen() % 22) };
+      sum += stair.add(p[0], p[1]);
+      points.push_back(p);
+    }
+    CHECK(sum == stair.area());
+    CHECK(stair.area() == cells(points, { 0, 0 }, { 20, 20 }));
+  }
+
+  for (int trial = 0; trial < 600; ++trial) {
+    int k = 2 + trial % 3;
+    Sense sense = ((trial / 3) % 2) ? MAX : MIN;
+    int side = (k == 4) ? 8 : 15;
+    std::vector<int> ideal(k), ref(k);
+    std::vector<double> idealBound(k), refBound(k);
+    for (int i = 0; i < k; ++i) {
+      ideal[i] = static_cast<int>(gen() % 10) - 5;
+      ref[i] = ideal[i] + side;
+      // In the problem's own terms.
+      idealBound[i] = (sense == MIN) ? ideal[i] : -ideal[i];
+      refBound[i] = (sense == MIN) ? ref[i] : -ref[i];
+    }
+    Hypervolume hv(k, sense, idealBound.data(), refBound.data());
+    CHECK(hv.boxVolume() == std::pow(side, k));
+    std::vector<std::vector<int>> points;
+    std::vector<int> s(k);
+    double sum = 0;
+    for (int n = 1 + gen() % 40; n > 0; --n) {
+      std::vector<int> p(k);
+      for (int i = 0; i < k; ++i) {
+        // Some points fall outside the box, and add nothing.
+        p[i] = ideal[i] + gen() % (side + 2);
+        s[i] = (sense == MIN) ? p[i] : -p[i];
+      }
+      double gain = hv.add(s.data());
+      CHECK(gain >= 0);
+      sum += gain;
+      points.push_back(p);
+      // Three objectives are only counted by refresh(), which may come at
+      // any time.
+      if (gen() % 4 == 0) {
+        gain = hv.refresh();
+        CHECK(gain >= 0);
+        sum += gain;
+      }
+    }
+    sum += hv.refresh();
+    CHECK(! hv.stale());
+    CHECK(std::fabs(sum - hv.value()) <= 1e-9 * hv.boxVolume());
+    double exact = cells(points, ideal, ref);
+    if (k <= 3) {
+      CHECK(hv.value() == exact);
+    } else {
+      CHECK(std::fabs(hv.value() - exact) <= 0.03 * hv.boxVolume());
+    }
+  }
+  return checkFailures() != 0;
+}
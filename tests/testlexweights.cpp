@@ -0,0 +1,96 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+/*
+ * Checks that the weights from lexicographicWeights() make the weighted sum
+ * order points lexicographically, on 3000 random point sets, and that
+ * weights are refused once the sum could exceed MAX_WEIGHTED.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "lexweights.h"
+
+int main() {
+  std::mt19937 gen(13);
+  int accepted = 0;
+  for (int trial = 0; trial < 3000; ++trial) {
+    int k = 1 + trial % 4;
+    std::vector<int> step(k);
+    std::vector<double> lower(k), upper(k), weights(k);
+    for (int i = 0; i < k; ++i) {
+      step[i] = 1 + gen() % 3;
+      int low = static_cast<int>(gen() % 41) - 20;
+      int steps = 1 + gen() % 30;
+      lower[i] = low * step[i];
+      upper[i] = lower[i] + steps * step[i];
+    }
+    if (! lexicographicWeights(step.data(), lower.data(), upper.data(), k,
+          weights.data())) {
+      CHECK(weightedSumBound(weights.data(), lower.data(), upper.data(), k)
+          > MAX_WEIGHTED);
+      continue;
+    }
+    accepted++;
+    // Random points on each objective's lattice, including its ends.
+    int n = 2 + gen() % 60;
+    std::vector<std::vector<int>> points(n, std::vector<int>(k));
+    for (auto & p : points) {
+      for (int i = 0; i < k; ++i) {
+        int steps = static_cast<int>((upper[i] - lower[i]) / step[i]);
+        int s = gen() % (steps + 1);
+        if (gen() % 8 == 0)
+          s = (gen() % 2) ? 0 : steps;
+        p[i] = static_cast<int>(lower[i]) + s * step[i];
+      }
+    }
+    // The weighted minimum must be the lexicographic minimum, and every
+    // point with the same weighted value must be that same point.
+    size_t lexmin = 0;
+    for (size_t j = 1; j < points.size(); ++j) {
+      if (points[j] < points[lexmin])
+        lexmin = j;
+    }
+    auto sum = [&](const std::vector<int> & p) {
+      double s = 0;
+      for (int i = 0; i < k; ++i) {
+        s += weights[i] * p[i];
+      }
+      return s;
+    };
+    double best = sum(points[lexmin]);
+    for (const auto & p : points) {
+      double s = sum(p);
+      CHECK(s >= best);
+      if (s == best)
+        CHECK(p == points[lexmin]);
+      // Every weighted value is exact, so this is an integer.
+      CHECK(s == std::floor(s));
+    }
+  }
+  // Most of these sets are small enough to weight.
+  CHECK(accepted > 2000);
+
+  // Four objectives over [0, 100] need weights up to about 1e6, so their
+  // sum can reach about 1e8: too large.
+  int step[] = { 1, 1, 1, 1 };
+  double lower[] = { 0, 0, 0, 0 };
+  double upper[] = { 100, 100, 100, 100 };
+  double weights[4];
+  CHECK(! lexicographicWeights(step, lower, upper, 4, weights));
+  CHECK(lexicographicWeights(step, lower, upper, 3, weights));
+  return checkFailures() != 0;
+}
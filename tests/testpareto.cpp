@@ -0,0 +1,142 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+/*
+ * Checks findDominated(), and Task::cleanSolutions() which is built on it,
+ * against the definition of dominance on random sets of solutions.
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "pareto.h"
+#include "task.h"
+
+/* A task that does nothing but hold solutions. */
+class PointTask : public Task {
+  public:
+    PointTask(int k, int * objectives, Sense sense);
+    Status operator()();
+    std::string str() const;
+    std::string details() const;
+    void add(const int * values);
+};
+
+PointTask::PointTask(int k, int * objectives, Sense sense) :
+    Task("", k, k, objectives, sense) {
+}
+
+Status PointTask::operator()() {
+  return DONE;
+}
+
+std::string PointTask::str() const {
+  return "PointTask";
+}
+
+std::string PointTask::details() const {
+  return "";
+}
+
+void PointTask::add(const int * values) {
+  int * s = newSolution();
+  std::copy(values, values + objCount_, s);
+}
+
+/* Is a at least as good as b everywhere, and better somewhere? */
+static bool dominates(const int * a, const int * b, int k, Sense sense) {
+  bool better = false;
+  for (int i = 0; i < k; ++i) {
+    if ((sense == MIN) ? (a[i] > b[i]) : (a[i] < b[i]))
+      return false;
+    if (a[i] != b[i])
+      better = true;
+  }
+  return better;
+}
+
+/* Does a come before b in the order of Task::sortSolutions()? */
+static bool before(const int * a, const int * b, int k) {
+  for (int i = 0; i < k; ++i) {
+    if (a[i] != b[i])
+      return a[i] > b[i];
+  }
+  return false;
+}
+
+int main() {
+  std::mt19937 gen(1);
+  int objectives[] = { 0, 1, 2, 3, 4, 5, 6 };
+  for (int trial = 0; trial < 3000; ++trial) {
+    int k = 1 + trial % 7;
+    Sense sense = ((trial / 7) % 2) ? MAX : MIN;
+    int n = gen() % 300 + 1;
+    int range = 2 + gen() % 50;
+    std::vector<std::vector<int>> values(n, std::vector<int>(k));
+    for (auto & v : values) {
+      for (int j = 0; j < k; ++j) {
+        v[j] = gen() % range;
+      }
+      // Some points on a plane, so that fronts are not tiny.
+      if (gen() % 3 == 0) {
+        int sum = 0;
+        for (int j = 0; j < k - 1; ++j) {
+          sum += v[j];
+        }
+        v[k - 1] = range * k - sum;
+      }
+    }
+    std::vector<const int *> points;
+    for (auto & v : values) {
+      points.push_back(v.data());
+    }
+
+    std::vector<char> dominated = findDominated(points, k, sense,
+        1 + trial % 4);
+    CHECK(dominated.size() == points.size());
+    std::vector<const int *> expected;
+    for (int i = 0; i < n; ++i) {
+      bool d = false;
+      for (int j = 0; (j < n) && (! d); ++j) {
+        d = dominates(points[j], points[i], k, sense);
+      }
+      CHECK((dominated[i] != 0) == d);
+      if (d)
+        continue;
+      bool duplicate = false;
+      for (const int * e : expected) {
+        duplicate = duplicate || std::equal(e, e + k, points[i]);
+      }
+      if (! duplicate)
+        expected.push_back(points[i]);
+    }
+
+    // cleanSolutions() keeps one of each nondominated point, in sorted order.
+    std::stable_sort(expected.begin(), expected.end(),
+        [k](const int * a, const int * b) { return before(a, b, k); });
+    PointTask task(k, objectives, sense);
+    for (const int * p : points) {
+      task.add(p);
+    }
+    task.cleanSolutions(1 + trial % 4);
+    const std::vector<const int *> & kept = task.solutions();
+    CHECK(kept.size() == expected.size());
+    for (size_t i = 0; (i < kept.size()) && (i < expected.size()); ++i) {
+      CHECK(std::equal(kept[i], kept[i] + k, expected[i]));
+    }
+  }
+  return checkFailures() != 0;
+}
@@ -0,0 +1,175 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+/*
+ * Checks ParetoArchive against the definition of dominance on random
+ * insertions, and checks that a task streaming into an archive ends up with
+ * the same solutions as one that gathers and cleans them, without keeping
+ * its pre-requisites' blocks alive.
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "paretoarchive.h"
+#include "task.h"
+
+/* A task whose solutions are added from outside. With an archive, it
+ * streams the solutions of its pre-requisites, otherwise it gathers and
+ * cleans them. */
+class PointTask : public Task {
+  public:
+    PointTask(int k, int * objectives, Sense sense, bool archive);
+    Status operator()();
+    std::string str() const;
+    std::string details() const;
+    int * add();
+};
+
+PointTask::PointTask(int k, int * objectives, Sense sense, bool archive) :
+    Task("", k, k + 1, objectives, sense) {
+  if (archive)
+    archive_ = new ParetoArchive(k, k + 1, sense);
+}
+
+Status PointTask::operator()() {
+  gatherSolutions();
+  if (archive_ == nullptr)
+    cleanSolutions();
+  done();
+  return status_;
+}
+
+std::string PointTask::str() const {
+  return "PointTask";
+}
+
+std::string PointTask::details() const {
+  return "";
+}
+
+int * PointTask::add() {
+  return newSolution();
+}
+
+/* Is a at least as good as b everywhere, and better somewhere? */
+static bool dominates(const int * a, const int * b, int k, Sense sense) {
+  bool better = false;
+  for (int i = 0; i < k; ++i) {
+    if ((sense == MIN) ? (a[i] > b[i]) : (a[i] < b[i]))
+      return false;
+    if (a[i] != b[i])
+      better = true;
+  }
+  return better;
+}
+
+static std::vector<std::vector<int>> values(
+    const std::vector<const int *> & solutions, int width) {
+  std::vector<std::vector<int>> res;
+  for (const int * s : solutions) {
+    res.push_back(std::vector<int>(s, s + width));
+  }
+  return res;
+}
+
+int main() {
+  std::mt19937 gen(9);
+  int objectives[] = { 0, 1, 2, 3, 4, 5 };
+
+  // Insertions one at a time. The last value is not compared, and shows
+  // which of equal solutions was kept.
+  for (int trial = 0; trial < 2000; ++trial) {
+    int k = 1 + trial % 6;
+    Sense sense = ((trial / 6) % 2) ? MAX : MIN;
+    int range = 2 + gen() % 40;
+    int n = 1 + gen() % 300;
+    ParetoArchive archive(k, k + 1, sense);
+    std::vector<std::vector<int>> points(n, std::vector<int>(k + 1));
+    std::vector<bool> kept(n, false);
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < k; ++j) {
+        points[i][j] = gen() % range;
+      }
+      points[i][k] = i;
+      const int * copy = archive.insert(points[i].data());
+      bool covered = false;
+      for (int j = 0; j < i; ++j) {
+        covered = covered || (kept[j] &&
+            (dominates(points[j].data(), points[i].data(), k, sense) ||
+             std::equal(points[j].begin(), points[j].begin() + k,
+               points[i].begin())));
+      }
+      CHECK((copy == nullptr) == covered);
+      if (copy != nullptr) {
+        CHECK(copy != points[i].data());
+        CHECK(std::equal(copy, copy + k + 1, points[i].begin()));
+        kept[i] = true;
+        for (int j = 0; j < i; ++j) {
+          if (dominates(points[i].data(), points[j].data(), k, sense))
+            kept[j] = false;
+        }
+      }
+    }
+    std::vector<std::vector<int>> expected;
+    for (int i = 0; i < n; ++i) {
+      if (kept[i])
+        expected.push_back(points[i]);
+    }
+    std::vector<std::vector<int>> got = values(archive.solutions(), k + 1);
+    CHECK(archive.size() == expected.size());
+    std::sort(expected.begin(), expected.end());
+    std::sort(got.begin(), got.end());
+    CHECK(got == expected);
+  }
+
+  // Streaming through tasks. The producers are deleted before the
+  // consumers' solutions are read, so any solution still pointing into
+  // their blocks would be caught by a memory checker.
+  for (int trial = 0; trial < 500; ++trial) {
+    int k = 1 + trial % 6;
+    Sense sense = ((trial / 6) % 2) ? MAX : MIN;
+    int range = 2 + gen() % 40;
+    PointTask streamed(k, objectives, sense, true);
+    PointTask gathered(k, objectives, sense, false);
+    std::vector<PointTask *> producers;
+    for (int p = 0; p < 1 + trial % 5; ++p) {
+      PointTask * producer = new PointTask(k, objectives, sense, false);
+      streamed.addPreReq(producer);
+      gathered.addPreReq(producer);
+      int n = gen() % 200;
+      for (int i = 0; i < n; ++i) {
+        int * s = producer->add();
+        for (int j = 0; j < k; ++j) {
+          s[j] = gen() % range;
+        }
+        s[k] = 1000 * p + i;
+      }
+      producers.push_back(producer);
+    }
+    for (PointTask * producer : producers) {
+      (*producer)();
+    }
+    gathered();
+    for (PointTask * producer : producers) {
+      delete producer;
+    }
+    streamed();
+    CHECK(values(streamed.solutions(), k + 1) ==
+        values(gathered.solutions(), k + 1));
+  }
+  return checkFailures() != 0;
+}
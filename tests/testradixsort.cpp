@@ -0,0 +1,101 @@
+/*
+
+k-PPM - An implementation of the k-PPM method for multi-objective optimisation
+Copyright (C) 2017 William Pettersson <william.pettersson@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+*/
+
+/*
+ * Checks radixSortUnique() against a stable sort and unique on random sets
+ * of solutions, and checks when it declines to sort.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "radixsort.h"
+
+/* Sort and deduplicate the way radixSortUnique() promises to. */
+static std::vector<const int *> expected(std::vector<const int *> solutions,
+    int k) {
+  auto before = [k](const int * a, const int * b) {
+    for (int i = 0; i < k; ++i) {
+      if (a[i] != b[i])
+        return a[i] > b[i];
+    }
+    return false;
+  };
+  auto same = [k](const int * a, const int * b) {
+    return std::equal(a, a + k, b);
+  };
+  std::stable_sort(solutions.begin(), solutions.end(), before);
+  solutions.erase(std::unique(solutions.begin(), solutions.end(), same),
+      solutions.end());
+  return solutions;
+}
+
+int main() {
+  std::mt19937 gen(5);
+  for (int trial = 0; trial < 2000; ++trial) {
+    int k = 1 + trial % 6;
+    int n = 64 + gen() % 500;
+    // Small ranges give many duplicates, large ones use many bits.
+    int range = (trial % 3 == 0) ? 4 : (1 << (gen() % 20));
+    int offset = static_cast<int>(gen() % 2001) - 1000;
+    std::vector<std::vector<int>> values(n, std::vector<int>(k + 1));
+    std::vector<const int *> solutions;
+    for (auto & v : values) {
+      for (int j = 0; j < k; ++j) {
+        v[j] = offset + static_cast<int>(gen() % range);
+      }
+      // Not compared, but shows which of equal solutions was kept.
+      v[k] = solutions.size();
+      solutions.push_back(v.data());
+    }
+    std::vector<const int *> want = expected(solutions, k);
+    bool sorted = radixSortUnique(solutions, k);
+    // Up to 6 objectives of at most 20 bits always fit in 128 bits.
+    CHECK(sorted);
+    CHECK(solutions == want);
+  }
+
+  // Too few solutions: left alone.
+  std::vector<int> small(63);
+  std::vector<const int *> few;
+  for (int & v : small) {
+    v = -static_cast<int>(few.size());
+    few.push_back(&v);
+  }
+  std::vector<const int *> copy(few);
+  CHECK(! radixSortUnique(few, 1));
+  CHECK(few == copy);
+
+  // The whole int range in five objectives needs 160 bits: left alone.
+  std::vector<std::vector<int>> wide(100, std::vector<int>(5));
+  std::vector<const int *> many;
+  for (size_t i = 0; i < wide.size(); ++i) {
+    for (int j = 0; j < 5; ++j) {
+      wide[i][j] = (i % 2) ? INT_MAX : INT_MIN;
+    }
+    many.push_back(wide[i].data());
+  }
+  copy = many;
+  CHECK(! radixSortUnique(many, 5));
+  CHECK(many == copy);
+
+  // The whole int range in four objectives fits exactly.
+  CHECK(radixSortUnique(many, 4));
+  CHECK(many.size() == 2);
+  CHECK((many.size() == 2) && (many[0][0] == INT_MAX) &&
+      (many[1][0] == INT_MIN));
+  return checkFailures() != 0;
+}